@@ -0,0 +1,131 @@
+#ifndef ACCOUNT_INDEX_HPP
+#define ACCOUNT_INDEX_HPP
+
+#include "HashIndex.hpp"
+#include "Transaction.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Account-centric index in CSR form. Accounts get dense ids; for each
+// direction, offsets[a]..offsets[a+1] delimits that account's row ids
+// in a single array, ordered by timestamp.
+// ------------------------------------------------------------------
+class AccountIndex {
+public:
+    enum Direction { OUTGOING, INCOMING, ALL };
+
+private:
+    struct Csr {
+        std::vector<uint32_t> offsets;   // accounts + 1 entries
+        std::vector<uint32_t> rowIds;
+    };
+
+    std::vector<std::string> accounts;   // dense id -> account
+    HashIndex                byName;     // account -> dense id
+    Csr                      out, in;    // by sender, by receiver
+    bool                     ready = false;
+
+    template <class RowAt>
+    void buildCsr(Csr& c, uint32_t n, RowAt rowAt, const std::vector<uint32_t>& acctOfRow) {
+        c.offsets.assign(accounts.size() + 1, 0);
+        for (uint32_t r = 0; r < n; ++r) ++c.offsets[acctOfRow[r] + 1];
+        for (size_t a = 0; a < accounts.size(); ++a) c.offsets[a + 1] += c.offsets[a];
+
+        c.rowIds.resize(n);
+        std::vector<uint32_t> fill(c.offsets.begin(), c.offsets.end() - 1);
+        for (uint32_t r = 0; r < n; ++r) c.rowIds[fill[acctOfRow[r]]++] = r;
+
+        for (size_t a = 0; a < accounts.size(); ++a) {
+            auto b = c.rowIds.begin() + c.offsets[a], e = c.rowIds.begin() + c.offsets[a + 1];
+            if (e - b > 1)
+                std::stable_sort(b, e, [&](uint32_t x, uint32_t y) {
+                    return rowAt(x).timestamp < rowAt(y).timestamp;
+                });
+        }
+    }
+
+    template <class RowAt, class KeyOf>
+    std::vector<uint32_t> assignIds(uint32_t n, RowAt rowAt, KeyOf keyOf,
+                                    std::unordered_map<std::string, uint32_t>& ids) {
+        std::vector<uint32_t> acctOfRow(n);
+        for (uint32_t r = 0; r < n; ++r) {
+            const std::string& k = keyOf(rowAt(r));
+            auto it = ids.find(k);
+            if (it == ids.end()) {
+                it = ids.emplace(k, uint32_t(accounts.size())).first;
+                accounts.push_back(k);
+            }
+            acctOfRow[r] = it->second;
+        }
+        return acctOfRow;
+    }
+
+public:
+    template <class RowAt>
+    void build(uint32_t n, RowAt rowAt) {
+        clear();
+        std::unordered_map<std::string, uint32_t> ids;
+        auto sender   = [](const Transaction& t) -> const std::string& { return t.sender_account; };
+        auto receiver = [](const Transaction& t) -> const std::string& { return t.receiver_account; };
+        std::vector<uint32_t> bySender   = assignIds(n, rowAt, sender, ids);
+        std::vector<uint32_t> byReceiver = assignIds(n, rowAt, receiver, ids);
+        buildCsr(out, n, rowAt, bySender);
+        buildCsr(in,  n, rowAt, byReceiver);
+        byName.build(uint32_t(accounts.size()),
+                     [this](uint32_t a) -> const std::string& { return accounts[a]; });
+        ready = true;
+    }
+
+    void clear() {
+        accounts.clear(); accounts.shrink_to_fit();
+        byName.clear();
+        out = Csr();
+        in  = Csr();
+        ready = false;
+    }
+
+    bool   built()        const { return ready; }
+    size_t accountCount() const { return accounts.size(); }
+
+    // Row ids for one account, ordered by timestamp. ALL merges both
+    // directions; a self-transfer appears once.
+    template <class RowAt>
+    std::vector<uint32_t> lookup(const std::string& account, Direction d, RowAt rowAt) const {
+        std::vector<uint32_t> res;
+        int64_t a = byName.find(account,
+                                [this](uint32_t i) -> const std::string& { return accounts[i]; });
+        if (a < 0) return res;
+
+        const uint32_t* ob = out.rowIds.data() + out.offsets[a];
+        const uint32_t* oe = out.rowIds.data() + out.offsets[a + 1];
+        const uint32_t* ib = in.rowIds.data()  + in.offsets[a];
+        const uint32_t* ie = in.rowIds.data()  + in.offsets[a + 1];
+        if (d == OUTGOING) return std::vector<uint32_t>(ob, oe);
+        if (d == INCOMING) return std::vector<uint32_t>(ib, ie);
+
+        res.reserve((oe - ob) + (ie - ib));
+        while (ob != oe || ib != ie) {
+            if (ib != ie && rowAt(*ib).sender_account == account) { ++ib; continue; } // self-transfer
+            if (ib == ie || (ob != oe && !(rowAt(*ib).timestamp < rowAt(*ob).timestamp)))
+                res.push_back(*ob++);
+            else
+                res.push_back(*ib++);
+        }
+        return res;
+    }
+
+    size_t memoryBytes() const {
+        size_t b = byName.memoryBytes()
+                 + (out.offsets.capacity() + out.rowIds.capacity()
+                    + in.offsets.capacity() + in.rowIds.capacity()) * sizeof(uint32_t);
+        for (const auto& s : accounts) b += sizeof(std::string) + s.capacity();
+        return b;
+    }
+};
+
+#endif
@@ -0,0 +1,277 @@
+#ifndef ADAPTIVE_SORT_HPP
+#define ADAPTIVE_SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Adaptive, stable merge sort in the style of TimSort. The input is cut
+// into natural runs (non-descending, or strictly descending and then
+// reversed); runs shorter than minRun are extended by binary insertion.
+// Runs are merged off a stack whose lengths grow like Fibonacci numbers,
+// so merges stay balanced. Before a merge, the head of the left run and
+// the tail of the right run that are already in place are skipped by
+// galloping (exponential then binary search). During a merge, once one
+// side wins MIN_GALLOP times in a row, whole blocks are copied at a time.
+// Sorted input is a single run: n - 1 comparisons and no moves.
+// ------------------------------------------------------------------
+namespace adsort {
+
+const size_t MIN_MERGE  = 32;    // below this, one binary insertion sort
+const size_t MIN_GALLOP = 7;
+
+struct Stats {
+    size_t runs     = 0;    // runs pushed, natural or extended to minRun
+    size_t galloped = 0;    // elements placed by a gallop instead of one by one
+};
+
+// Number of leading elements of base[0, len) for which pred holds (pred
+// is true on a prefix). Probes 1, 3, 7, ... from the left or the right
+// end, then binary-searches the bracket.
+template <class T, class Pred>
+size_t gallop(const T* base, size_t len, Pred pred, bool fromRight) {
+    size_t prev = 0, ofs = 1;
+    if (!fromRight) {
+        while (ofs <= len && pred(base[ofs-1])) { prev = ofs; ofs = ofs * 2 + 1; }
+        return std::partition_point(base + prev, base + std::min(ofs - 1, len), pred) - base;
+    }
+    while (ofs <= len && !pred(base[len-ofs])) { prev = ofs; ofs = ofs * 2 + 1; }
+    size_t lo = ofs <= len ? len - ofs + 1 : 0;
+    return std::partition_point(base + lo, base + (len - prev), pred) - base;
+}
+
+template <class T, class Less>
+class RunMerger {
+    struct Run { size_t base, len; };
+
+    T*               a;
+    Less             less;
+    std::vector<T>   tmp;
+    std::vector<Run> stack;
+    size_t           minGallop = MIN_GALLOP;
+    Stats            st;
+
+    // elements of base[0, len) that go before key: < key (left) or <= key (right)
+    size_t gallopLeft(const T& key, const T* base, size_t len, bool fromRight) {
+        return gallop(base, len, [&](const T& x){ return less(x, key); }, fromRight);
+    }
+    size_t gallopRight(const T& key, const T* base, size_t len, bool fromRight) {
+        return gallop(base, len, [&](const T& x){ return !less(key, x); }, fromRight);
+    }
+
+    static size_t minRunLength(size_t n) {
+        size_t r = 0;
+        while (n >= MIN_MERGE) { r |= n & 1; n >>= 1; }
+        return n + r;
+    }
+
+    // Length of the run starting at lo (at most hi - lo), made ascending.
+    size_t countRun(size_t lo, size_t hi) {
+        size_t i = lo + 1;
+        if (i == hi) return 1;
+        if (less(a[i], a[lo])) {
+            while (++i < hi && less(a[i], a[i-1])) {}
+            std::reverse(a + lo, a + i);
+        } else {
+            while (++i < hi && !less(a[i], a[i-1])) {}
+        }
+        return i - lo;
+    }
+
+    // a[lo, start) is sorted; inserts a[start, hi) after equal elements.
+    void binaryInsertion(size_t lo, size_t hi, size_t start) {
+        for (size_t i = start; i < hi; ++i) {
+            T v = a[i];
+            T* pos = std::upper_bound(a + lo, a + i, v, less);
+            std::move_backward(pos, a + i, a + i + 1);
+            *pos = v;
+        }
+    }
+
+    // Merges adjacent runs, left one no longer than the right; a[base2]
+    // < a[base1] and a[base1+len1-1] > a[base2+len2-1] (see mergeAt).
+    void mergeLo(size_t base1, size_t len1, size_t base2, size_t len2) {
+        tmp.assign(a + base1, a + base1 + len1);
+        const T* c1 = tmp.data();
+        T* c2   = a + base2;
+        T* dest = a + base1;
+        size_t n1 = len1, n2 = len2;
+
+        *dest++ = *c2++;
+        if (--n2 == 0) { std::copy(c1, c1 + n1, dest); return; }
+        if (n1 == 1)   { dest = std::copy(c2, c2 + n2, dest); *dest = *c1; return; }
+
+        size_t mg = minGallop;
+        while (true) {
+            size_t w1 = 0, w2 = 0;   // consecutive wins of each side
+            do {
+                if (less(*c2, *c1)) {
+                    *dest++ = *c2++; ++w2; w1 = 0;
+                    if (--n2 == 0) goto done;
+                } else {
+                    *dest++ = *c1++; ++w1; w2 = 0;
+                    if (--n1 == 1) goto done;
+                }
+            } while (std::max(w1, w2) < mg);
+
+            do {
+                w1 = gallopRight(*c2, c1, n1, false);
+                if (w1) {
+                    dest = std::copy(c1, c1 + w1, dest);
+                    c1 += w1; n1 -= w1; st.galloped += w1;
+                    if (n1 <= 1) goto done;
+                }
+                *dest++ = *c2++;
+                if (--n2 == 0) goto done;
+
+                w2 = gallopLeft(*c1, c2, n2, false);
+                if (w2) {
+                    dest = std::copy(c2, c2 + w2, dest);
+                    c2 += w2; n2 -= w2; st.galloped += w2;
+                    if (n2 == 0) goto done;
+                }
+                *dest++ = *c1++;
+                if (--n1 == 1) goto done;
+                if (mg > 1) --mg;
+            } while (w1 >= MIN_GALLOP || w2 >= MIN_GALLOP);
+            mg += 2;   // galloping stopped paying off
+        }
+    done:
+        minGallop = std::max<size_t>(mg, 1);
+        if (n1 == 1)      { dest = std::copy(c2, c2 + n2, dest); *dest = *c1; }
+        else if (n2 == 0) std::copy(c1, c1 + n1, dest);
+    }
+
+    // Mirror of mergeLo for a left run longer than the right one: the
+    // right run goes to tmp and the merge fills a from the back. n1 and
+    // n2 are the unmerged counts; the next free slot is base1 + n1 + n2 - 1.
+    void mergeHi(size_t base1, size_t len1, size_t base2, size_t len2) {
+        tmp.assign(a + base2, a + base2 + len2);
+        T* r1 = a + base1;
+        const T* r2 = tmp.data();
+        size_t n1 = len1, n2 = len2;
+
+        r1[n1 + n2 - 1] = r1[n1 - 1];
+        if (--n1 == 0) { std::copy(r2, r2 + n2, r1); return; }
+        if (n2 == 1)   { std::move_backward(r1, r1 + n1, r1 + n1 + 1); r1[0] = r2[0]; return; }
+
+        size_t mg = minGallop;
+        while (true) {
+            size_t w1 = 0, w2 = 0;
+            do {
+                if (less(r2[n2-1], r1[n1-1])) {
+                    r1[n1 + n2 - 1] = r1[n1 - 1]; ++w1; w2 = 0;
+                    if (--n1 == 0) goto done;
+                } else {
+                    r1[n1 + n2 - 1] = r2[n2 - 1]; ++w2; w1 = 0;
+                    if (--n2 == 1) goto done;
+                }
+            } while (std::max(w1, w2) < mg);
+
+            do {
+                w1 = n1 - gallopRight(r2[n2-1], r1, n1, true);   // run-1 tail above r2[n2-1]
+                if (w1) {
+                    std::move_backward(r1 + n1 - w1, r1 + n1, r1 + n1 + n2);
+                    n1 -= w1; st.galloped += w1;
+                    if (n1 == 0) goto done;
+                }
+                r1[n1 + n2 - 1] = r2[n2 - 1];
+                if (--n2 == 1) goto done;
+
+                w2 = n2 - gallopLeft(r1[n1-1], r2, n2, true);    // run-2 tail not below r1[n1-1]
+                if (w2) {
+                    std::copy(r2 + n2 - w2, r2 + n2, r1 + n1 + n2 - w2);
+                    n2 -= w2; st.galloped += w2;
+                    if (n2 <= 1) goto done;
+                }
+                r1[n1 + n2 - 1] = r1[n1 - 1];
+                if (--n1 == 0) goto done;
+                if (mg > 1) --mg;
+            } while (w1 >= MIN_GALLOP || w2 >= MIN_GALLOP);
+            mg += 2;
+        }
+    done:
+        minGallop = std::max<size_t>(mg, 1);
+        if (n2 == 1)      { std::move_backward(r1, r1 + n1, r1 + n1 + 1); r1[0] = r2[0]; }
+        else if (n1 == 0) std::copy(r2, r2 + n2, r1);
+    }
+
+    // Merges stack[i] and stack[i+1].
+    void mergeAt(size_t i) {
+        size_t base1 = stack[i].base,   len1 = stack[i].len;
+        size_t base2 = stack[i+1].base, len2 = stack[i+1].len;
+        stack[i].len = len1 + len2;
+        stack.erase(stack.begin() + i + 1);
+
+        // left-run head already <= the right run's first element stays put
+        size_t k = gallopRight(a[base2], a + base1, len1, false);
+        base1 += k; len1 -= k; st.galloped += k;
+        if (len1 == 0) return;
+        // right-run tail already >= the left run's last element stays put
+        size_t keep = gallopLeft(a[base1 + len1 - 1], a + base2, len2, true);
+        st.galloped += len2 - keep;
+        len2 = keep;
+        if (len2 == 0) return;
+
+        if (len1 <= len2) mergeLo(base1, len1, base2, len2);
+        else              mergeHi(base1, len1, base2, len2);
+    }
+
+    // Keeps len[i-2] > len[i-1] + len[i] and len[i-1] > len[i] down the stack.
+    void mergeCollapse() {
+        while (stack.size() > 1) {
+            size_t k = stack.size() - 2;
+            if ((k > 0 && stack[k-1].len <= stack[k].len + stack[k+1].len) ||
+                (k > 1 && stack[k-2].len <= stack[k-1].len + stack[k].len)) {
+                if (stack[k-1].len < stack[k+1].len) --k;
+            } else if (stack[k].len > stack[k+1].len) {
+                break;
+            }
+            mergeAt(k);
+        }
+    }
+
+public:
+    RunMerger(T* data, Less l) : a(data), less(l) {}
+
+    Stats operator()(size_t n) {
+        st = Stats();
+        if (n < 2) { st.runs = n; return st; }
+        if (n < MIN_MERGE) {
+            binaryInsertion(0, n, countRun(0, n));
+            st.runs = 1;
+            return st;
+        }
+        size_t minRun = minRunLength(n);
+        for (size_t lo = 0; lo < n; ) {
+            size_t len = countRun(lo, n);
+            if (len < minRun) {
+                size_t force = std::min(minRun, n - lo);
+                binaryInsertion(lo, lo + force, lo + len);
+                len = force;
+            }
+            stack.push_back({ lo, len });
+            ++st.runs;
+            mergeCollapse();
+            lo += len;
+        }
+        while (stack.size() > 1) {
+            size_t k = stack.size() - 2;
+            if (k > 0 && stack[k-1].len < stack[k+1].len) --k;
+            mergeAt(k);
+        }
+        stack.clear();
+        return st;
+    }
+};
+
+template <class T, class Less>
+Stats adaptiveSort(T* a, size_t n, Less less) {
+    RunMerger<T, Less> m(a, less);
+    return m(n);
+}
+
+} // namespace adsort
+
+#endif
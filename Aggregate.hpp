@@ -0,0 +1,51 @@
+#ifndef AGGREGATE_HPP
+#define AGGREGATE_HPP
+
+#include "Bitmap.hpp"
+#include "Transaction.hpp"
+
+#include <cstdint>
+#include <limits>
+
+// ------------------------------------------------------------------
+// Running COUNT / SUM / MIN / MAX of amount and fraud count, folded
+// row by row over index postings without materializing the rows.
+// ------------------------------------------------------------------
+struct Aggregate {
+    uint64_t count = 0;
+    uint64_t fraud = 0;
+    double   sum   = 0;
+    double   min   = std::numeric_limits<double>::infinity();
+    double   max   = -std::numeric_limits<double>::infinity();
+
+    void add(const Transaction& t) {
+        ++count;
+        fraud += t.is_fraud;
+        sum   += t.amount;
+        if (t.amount < min) min = t.amount;
+        if (t.amount > max) max = t.amount;
+    }
+
+    double avg()       const { return count ? sum / count : 0; }
+    double fraudRate() const { return count ? double(fraud) / count : 0; }
+};
+
+// Aggregate over the rows of a bitmap; countOnly answers from the
+// bitmap alone without touching a row.
+template <class RowAt>
+Aggregate aggregateRows(const Bitmap& rows, RowAt rowAt, bool countOnly = false) {
+    Aggregate a;
+    if (countOnly) { a.count = rows.cardinality(); return a; }
+    rows.forEach([&](uint32_t r){ a.add(rowAt(r)); });
+    return a;
+}
+
+template <class RowAt>
+Aggregate aggregateAll(uint32_t n, RowAt rowAt, bool countOnly = false) {
+    Aggregate a;
+    if (countOnly) { a.count = n; return a; }
+    for (uint32_t r = 0; r < n; ++r) a.add(rowAt(r));
+    return a;
+}
+
+#endif
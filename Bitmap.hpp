@@ -0,0 +1,292 @@
+#ifndef BITMAP_HPP
+#define BITMAP_HPP
+
+#include "Simd.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+
+// ------------------------------------------------------------------
+// Compressed row-id bitmap (Roaring layout).
+// Row ids are split into 2^16-row chunks; each chunk is stored either
+// as a sorted uint16 array (sparse) or a 1024-word bitset (dense).
+// AND/OR/ANDNOT on two dense chunks run through the SIMD word kernels.
+// ------------------------------------------------------------------
+class Bitmap {
+    static constexpr uint32_t CHUNK_BITS  = 1u << 16;
+    static constexpr uint32_t WORDS       = CHUNK_BITS / 64;
+    static constexpr uint32_t ARRAY_LIMIT = 4096;   // above this a bitset is smaller
+
+    struct Container {
+        uint16_t              key  = 0;
+        uint32_t              card = 0;
+        std::vector<uint16_t> arr;    // sorted values, when sparse
+        std::vector<uint64_t> words;  // WORDS entries, when dense
+
+        bool isBitset() const { return !words.empty(); }
+
+        bool contains(uint16_t v) const {
+            if (isBitset()) return (words[v >> 6] >> (v & 63)) & 1;
+            return std::binary_search(arr.begin(), arr.end(), v);
+        }
+
+        void toBitset() {
+            words.assign(WORDS, 0);
+            for (uint16_t v : arr) words[v >> 6] |= uint64_t(1) << (v & 63);
+            arr.clear();
+            arr.shrink_to_fit();
+        }
+
+        void toArrayIfSparse() {
+            if (!isBitset() || card > ARRAY_LIMIT) return;
+            arr.clear();
+            arr.reserve(card);
+            for (uint32_t w = 0; w < WORDS; ++w) {
+                uint64_t bits = words[w];
+                while (bits) {
+                    arr.push_back(uint16_t(w * 64 + simd::countTrailingZeros64(bits)));
+                    bits &= bits - 1;
+                }
+            }
+            words.clear();
+            words.shrink_to_fit();
+        }
+
+        void add(uint16_t v) {
+            if (isBitset()) {
+                uint64_t& w = words[v >> 6];
+                uint64_t  m = uint64_t(1) << (v & 63);
+                if (!(w & m)) { w |= m; ++card; }
+                return;
+            }
+            if (arr.empty() || arr.back() < v) arr.push_back(v);
+            else {
+                auto it = std::lower_bound(arr.begin(), arr.end(), v);
+                if (it != arr.end() && *it == v) return;
+                arr.insert(it, v);
+            }
+            if (++card > ARRAY_LIMIT) toBitset();
+        }
+
+        size_t memoryBytes() const {
+            return sizeof(Container) + arr.capacity() * sizeof(uint16_t)
+                 + words.capacity() * sizeof(uint64_t);
+        }
+    };
+
+    std::vector<Container> cs;  // sorted by key
+
+    // ---- per-chunk set operations ----
+    static Container andC(const Container& a, const Container& b) {
+        Container r; r.key = a.key;
+        if (a.isBitset() && b.isBitset()) {
+            r.words.resize(WORDS);
+            r.card = uint32_t(simd::wordOp(simd::WordOp::AND, a.words.data(), b.words.data(),
+                                           r.words.data(), WORDS));
+            r.toArrayIfSparse();
+        } else if (a.isBitset() || b.isBitset()) {
+            const Container& bs = a.isBitset() ? a : b;
+            const Container& ar = a.isBitset() ? b : a;
+            for (uint16_t v : ar.arr)
+                if (bs.contains(v)) r.arr.push_back(v);
+            r.card = uint32_t(r.arr.size());
+        } else {
+            std::set_intersection(a.arr.begin(), a.arr.end(), b.arr.begin(), b.arr.end(),
+                                  std::back_inserter(r.arr));
+            r.card = uint32_t(r.arr.size());
+        }
+        return r;
+    }
+
+    static Container orC(const Container& a, const Container& b) {
+        Container r; r.key = a.key;
+        if (a.isBitset() && b.isBitset()) {
+            r.words.resize(WORDS);
+            r.card = uint32_t(simd::wordOp(simd::WordOp::OR, a.words.data(), b.words.data(),
+                                           r.words.data(), WORDS));
+        } else if (a.isBitset() || b.isBitset()) {
+            r = a.isBitset() ? a : b;
+            const Container& ar = a.isBitset() ? b : a;
+            for (uint16_t v : ar.arr) r.add(v);
+        } else {
+            std::set_union(a.arr.begin(), a.arr.end(), b.arr.begin(), b.arr.end(),
+                           std::back_inserter(r.arr));
+            r.card = uint32_t(r.arr.size());
+            if (r.card > ARRAY_LIMIT) r.toBitset();
+        }
+        return r;
+    }
+
+    static Container andNotC(const Container& a, const Container& b) {
+        Container r; r.key = a.key;
+        if (a.isBitset() && b.isBitset()) {
+            r.words.resize(WORDS);
+            r.card = uint32_t(simd::wordOp(simd::WordOp::ANDNOT, a.words.data(), b.words.data(),
+                                           r.words.data(), WORDS));
+            r.toArrayIfSparse();
+        } else if (a.isBitset()) {
+            r = a;
+            for (uint16_t v : b.arr) {
+                uint64_t& w = r.words[v >> 6];
+                uint64_t  m = uint64_t(1) << (v & 63);
+                if (w & m) { w &= ~m; --r.card; }
+            }
+            r.toArrayIfSparse();
+        } else if (b.isBitset()) {
+            for (uint16_t v : a.arr)
+                if (!b.contains(v)) r.arr.push_back(v);
+            r.card = uint32_t(r.arr.size());
+        } else {
+            std::set_difference(a.arr.begin(), a.arr.end(), b.arr.begin(), b.arr.end(),
+                                std::back_inserter(r.arr));
+            r.card = uint32_t(r.arr.size());
+        }
+        return r;
+    }
+
+    Container& containerFor(uint16_t key) {
+        if (cs.empty() || cs.back().key < key) {
+            cs.emplace_back();
+            cs.back().key = key;
+            return cs.back();
+        }
+        auto it = std::lower_bound(cs.begin(), cs.end(), key,
+            [](const Container& c, uint16_t k){ return c.key < k; });
+        if (it == cs.end() || it->key != key) {
+            it = cs.emplace(it);
+            it->key = key;
+        }
+        return *it;
+    }
+
+public:
+    // All rows in [0, n).
+    static Bitmap range(uint32_t n) {
+        Bitmap b;
+        for (uint32_t base = 0; base < n; base += CHUNK_BITS) {
+            Container c;
+            c.key  = uint16_t(base >> 16);
+            c.card = std::min(CHUNK_BITS, n - base);
+            c.words.assign(WORDS, 0);
+            for (uint32_t w = 0; w < c.card / 64; ++w) c.words[w] = ~uint64_t(0);
+            if (c.card % 64) c.words[c.card / 64] = (uint64_t(1) << (c.card % 64)) - 1;
+            c.toArrayIfSparse();
+            b.cs.push_back(std::move(c));
+        }
+        return b;
+    }
+
+    // Appending in increasing row order is the fast path (used at load time).
+    void add(uint32_t row) {
+        containerFor(uint16_t(row >> 16)).add(uint16_t(row & 0xFFFF));
+    }
+
+    bool contains(uint32_t row) const {
+        uint16_t key = uint16_t(row >> 16);
+        auto it = std::lower_bound(cs.begin(), cs.end(), key,
+            [](const Container& c, uint16_t k){ return c.key < k; });
+        return it != cs.end() && it->key == key && it->contains(uint16_t(row & 0xFFFF));
+    }
+
+    uint64_t cardinality() const {
+        uint64_t c = 0;
+        for (const auto& x : cs) c += x.card;
+        return c;
+    }
+
+    bool empty() const { return cs.empty(); }
+
+    void clear() { cs.clear(); }
+
+    size_t memoryBytes() const {
+        size_t b = sizeof(Bitmap);
+        for (const auto& c : cs) b += c.memoryBytes();
+        return b;
+    }
+
+    // Calls f(row) for every row in ascending order.
+    template <class F>
+    void forEach(F f) const {
+        for (const auto& c : cs) {
+            uint32_t base = uint32_t(c.key) << 16;
+            if (c.isBitset()) {
+                for (uint32_t w = 0; w < WORDS; ++w) {
+                    uint64_t bits = c.words[w];
+                    while (bits) {
+                        f(base + w * 64 + simd::countTrailingZeros64(bits));
+                        bits &= bits - 1;
+                    }
+                }
+            } else {
+                for (uint16_t v : c.arr) f(base + v);
+            }
+        }
+    }
+
+    std::vector<int> toRowIds() const {
+        std::vector<int> out;
+        out.reserve(size_t(cardinality()));
+        forEach([&](uint32_t r){ out.push_back(int(r)); });
+        return out;
+    }
+
+    static Bitmap fromRowIds(const std::vector<int>& rows) {
+        Bitmap b;
+        for (int r : rows) b.add(uint32_t(r));
+        return b;
+    }
+
+    Bitmap operator&(const Bitmap& o) const {
+        Bitmap r;
+        size_t i = 0, j = 0;
+        while (i < cs.size() && j < o.cs.size()) {
+            if      (cs[i].key < o.cs[j].key) ++i;
+            else if (cs[i].key > o.cs[j].key) ++j;
+            else {
+                Container c = andC(cs[i++], o.cs[j++]);
+                if (c.card) r.cs.push_back(std::move(c));
+            }
+        }
+        return r;
+    }
+
+    Bitmap operator|(const Bitmap& o) const {
+        Bitmap r;
+        size_t i = 0, j = 0;
+        while (i < cs.size() || j < o.cs.size()) {
+            if (j == o.cs.size() || (i < cs.size() && cs[i].key < o.cs[j].key))
+                r.cs.push_back(cs[i++]);
+            else if (i == cs.size() || cs[i].key > o.cs[j].key)
+                r.cs.push_back(o.cs[j++]);
+            else
+                r.cs.push_back(orC(cs[i++], o.cs[j++]));
+        }
+        return r;
+    }
+
+    // Rows in *this but not in o.
+    Bitmap andNot(const Bitmap& o) const {
+        Bitmap r;
+        size_t j = 0;
+        for (const auto& c : cs) {
+            while (j < o.cs.size() && o.cs[j].key < c.key) ++j;
+            if (j < o.cs.size() && o.cs[j].key == c.key) {
+                Container d = andNotC(c, o.cs[j]);
+                if (d.card) r.cs.push_back(std::move(d));
+            } else {
+                r.cs.push_back(c);
+            }
+        }
+        return r;
+    }
+
+    // Complement within [0, n).
+    Bitmap flip(uint32_t n) const { return range(n).andNot(*this); }
+
+    Bitmap& operator&=(const Bitmap& o) { return *this = *this & o; }
+    Bitmap& operator|=(const Bitmap& o) { return *this = *this | o; }
+};
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef BITMAP_INDEX_HPP
+#define BITMAP_INDEX_HPP
+
+#include "Bitmap.hpp"
+#include "ScanKernels.hpp"
+#include "Transaction.hpp"
+#include "TransactionFields.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// ------------------------------------------------------------------
+// Inverted index over the categorical columns: for every distinct
+// value of every categorical field, one compressed bitmap of row ids,
+// plus the column itself as dictionary codes for vectorized scans.
+// Built row by row while a store ingests the CSV.
+// ------------------------------------------------------------------
+struct BitmapPredicate {
+    Field                    field;
+    std::vector<std::string> values;   // OR-ed together
+    bool                     negate = false;
+};
+
+class BitmapIndex {
+public:
+    struct Column {
+        std::unordered_map<std::string, int> codeOf;
+        std::vector<std::string>             values;
+        std::vector<Bitmap>                  bitmaps;
+        CodeColumn                           codes;    // per row
+
+        const Bitmap* find(const std::string& v) const {
+            auto it = codeOf.find(v);
+            return it == codeOf.end() ? nullptr : &bitmaps[it->second];
+        }
+
+        // Dictionary codes in ascending order of their values.
+        std::vector<uint32_t> codesByValue() const {
+            std::vector<uint32_t> byValue(values.size());
+            for (uint32_t i = 0; i < byValue.size(); ++i) byValue[i] = i;
+            std::sort(byValue.begin(), byValue.end(),
+                      [&](uint32_t x, uint32_t y){ return values[x] < values[y]; });
+            return byValue;
+        }
+    };
+
+private:
+    Column   cols[FIELD_COUNT];
+    uint32_t rows = 0;
+
+    void addValue(Field f, const std::string& v, uint32_t row) {
+        Column& c = cols[static_cast<int>(f)];
+        auto it = c.codeOf.find(v);
+        int code;
+        if (it == c.codeOf.end()) {
+            code = int(c.values.size());
+            c.codeOf.emplace(v, code);
+            c.values.push_back(v);
+            c.bitmaps.emplace_back();
+        } else {
+            code = it->second;
+        }
+        c.bitmaps[code].add(row);
+        c.codes.push(uint32_t(code));
+    }
+
+public:
+    void clear() {
+        for (auto& c : cols) c = Column();
+        rows = 0;
+    }
+
+    // Rows must be added with consecutive ids starting at 0.
+    void add(uint32_t row, const Transaction& t) {
+        for (int i = 0; i < FIELD_COUNT; ++i) {
+            Field f = static_cast<Field>(i);
+            if (!isCategorical(f)) continue;
+            if (const std::string* s = stringField(t, f)) addValue(f, *s, row);
+            else                                         addValue(f, fieldText(t, f), row);
+        }
+        if (row >= rows) rows = row + 1;
+    }
+
+    uint32_t size() const { return rows; }
+
+    bool hasField(Field f) const { return isCategorical(f); }
+
+    const Column& column(Field f) const { return cols[static_cast<int>(f)]; }
+
+    // OR of the bitmaps for the given values of one field.
+    Bitmap lookup(Field f, const std::vector<std::string>& values) const {
+        Bitmap r;
+        for (const auto& v : values)
+            if (const Bitmap* b = column(f).find(v)) r |= *b;
+        return r;
+    }
+
+    // AND of all predicates. Positive terms are intersected first and
+    // negated terms subtracted afterwards, so NOT never builds a complement
+    // unless every term is negated.
+    Bitmap evaluate(const std::vector<BitmapPredicate>& preds) const {
+        Bitmap acc;
+        bool   started = false;
+        for (const auto& p : preds) {
+            if (p.negate) continue;
+            Bitmap term = lookup(p.field, p.values);
+            acc = started ? (acc & term) : std::move(term);
+            started = true;
+            if (acc.empty()) return acc;
+        }
+        if (!started) acc = Bitmap::range(rows);
+        for (const auto& p : preds) {
+            if (!p.negate) continue;
+            acc = acc.andNot(lookup(p.field, p.values));
+        }
+        return acc;
+    }
+
+    // Linear scan of the code column instead of the bitmaps: selection
+    // bitmap ((size()+63)/64 words) of rows whose value is in values.
+    std::vector<uint64_t> scanCodes(Field f, const std::vector<std::string>& values,
+                                    ScanStats* st = nullptr) const {
+        const Column& c = column(f);
+        std::vector<uint64_t> sel((c.codes.size() + 63) / 64, 0);
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (const auto& v : values) {
+            auto it = c.codeOf.find(v);
+            if (it != c.codeOf.end()) c.codes.select(uint32_t(it->second), sel.data());
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        if (st) {
+            st->rows   = c.codes.size();
+            st->bytes  = c.codes.size() * c.codes.width() * values.size();
+            st->micros = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        }
+        return sel;
+    }
+
+    size_t memoryBytes() const {
+        size_t b = sizeof(BitmapIndex);
+        for (const auto& c : cols) {
+            b += c.codes.memoryBytes();
+            for (const auto& bm : c.bitmaps) b += bm.memoryBytes();
+            for (const auto& v : c.values)   b += v.capacity() + 2 * sizeof(std::string);
+        }
+        return b;
+    }
+};
+
+#endif
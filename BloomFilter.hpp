@@ -0,0 +1,144 @@
+#ifndef BLOOM_FILTER_HPP
+#define BLOOM_FILTER_HPP
+
+#include "HashIndex.hpp"
+#include "Simd.hpp"
+#include "Transaction.hpp"
+#include "TransactionFields.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Split-block Bloom filter: each key sets one bit in each of the eight
+// 32-bit words of a single 256-bit block, so a probe touches one cache
+// line. About 1% false positives at 10 bits per key; never a false
+// negative.
+// ------------------------------------------------------------------
+class BlockedBloomFilter {
+    typedef std::array<uint32_t, 8> Block;
+
+    std::vector<Block> blocks;
+    size_t             adds = 0;
+
+    static uint32_t bitOf(uint32_t key, int i) {
+        static const uint32_t SALT[8] = {
+            0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+            0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u };
+        return 1u << ((key * SALT[i]) >> 27);
+    }
+
+    size_t blockOf(uint64_t h) const {
+        return size_t(((h >> 32) * blocks.size()) >> 32);
+    }
+
+public:
+    void reset(size_t expectedKeys, double bitsPerKey = 10) {
+        size_t n = std::max<size_t>(1, size_t(expectedKeys * bitsPerKey / 256 + 1));
+        blocks.assign(n, Block());
+        adds = 0;
+    }
+
+    void clear() {
+        blocks.clear();
+        blocks.shrink_to_fit();
+        adds = 0;
+    }
+
+    bool built() const { return !blocks.empty(); }
+
+    void add(const std::string& key) {
+        uint64_t h = hashString(key);
+        Block& b = blocks[blockOf(h)];
+        for (int i = 0; i < 8; ++i) b[i] |= bitOf(uint32_t(h), i);
+        ++adds;
+    }
+
+    // false = key was never added; an empty filter rejects nothing.
+    bool mayContain(const std::string& key) const {
+        if (blocks.empty()) return true;
+        uint64_t h = hashString(key);
+        const Block& b = blocks[blockOf(h)];
+        for (int i = 0; i < 8; ++i)
+            if (!(b[i] & bitOf(uint32_t(h), i))) return false;
+        return true;
+    }
+
+    // Probability that an absent key passes, from the fill of each block.
+    double estimatedFpr() const {
+        if (blocks.empty()) return 0;
+        double sum = 0;
+        for (const Block& b : blocks) {
+            double p = 1;
+            for (uint32_t w : b) p *= simd::popcount64(w) / 32.0;
+            sum += p;
+        }
+        return sum / blocks.size();
+    }
+
+    // Fraction of `probes` synthetic keys (none of which occur in the
+    // data) that pass the filter.
+    double measuredFpr(size_t probes = 100000) const {
+        if (blocks.empty()) return 0;
+        size_t pass = 0;
+        for (size_t i = 0; i < probes; ++i)
+            pass += mayContain("\x1f" "absent#" + std::to_string(i));
+        return double(pass) / probes;
+    }
+
+    size_t insertions()  const { return adds; }
+    size_t memoryBytes() const { return blocks.capacity() * sizeof(Block); }
+};
+
+// ------------------------------------------------------------------
+// One filter per point-lookup column, built once a load has finished so
+// it is sized for the rows actually kept.
+// ------------------------------------------------------------------
+class FieldFilters {
+    BlockedBloomFilter filters[FIELD_COUNT];
+
+public:
+    static bool filtered(Field f) {
+        return f == Field::transaction_id || f == Field::sender_account
+            || f == Field::receiver_account || f == Field::location;
+    }
+
+    // Sized for maxRows keys (dictionary columns for far fewer).
+    void reset(size_t maxRows) {
+        for (int i = 0; i < FIELD_COUNT; ++i) {
+            Field f = static_cast<Field>(i);
+            if (!filtered(f)) continue;
+            filters[i].reset(isCategorical(f) ? std::min<size_t>(maxRows, 65536) : maxRows);
+        }
+    }
+
+    void clear() {
+        for (auto& b : filters) b.clear();
+    }
+
+    // Sizes for rows keys and adds rowAt(0) .. rowAt(rows - 1).
+    template <class RowAt>
+    void build(size_t rows, RowAt rowAt) {
+        reset(rows);
+        for (size_t r = 0; r < rows; ++r) add(rowAt(uint32_t(r)));
+    }
+
+    void add(const Transaction& t) {
+        filters[int(Field::transaction_id)].add(t.transaction_id);
+        filters[int(Field::sender_account)].add(t.sender_account);
+        filters[int(Field::receiver_account)].add(t.receiver_account);
+        filters[int(Field::location)].add(t.location);
+    }
+
+    // Only filtered columns can reject a key.
+    bool mayContain(Field f, const std::string& key) const {
+        return !filtered(f) || filters[int(f)].mayContain(key);
+    }
+
+    const BlockedBloomFilter& filter(Field f) const { return filters[int(f)]; }
+};
+
+#endif
@@ -0,0 +1,306 @@
+#ifndef EXTERNAL_SORT_HPP
+#define EXTERNAL_SORT_HPP
+
+#include "SortKeys.hpp"
+#include "TransactionFields.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+// ------------------------------------------------------------------
+// External merge sort of a CSV file, for inputs larger than memory.
+// Data lines are read into runs of at most budgetBytes, each run is
+// sorted and spilled to a temporary file, and the runs are merged
+// through a loser tree into one sorted CSV (header first). More than
+// MAX_FANIN runs are merged in several passes. Equal keys keep input
+// order. While the output is written, the byte offset of every
+// rowsPerMark-th row is recorded so readers can seek straight to a page.
+// ------------------------------------------------------------------
+namespace extsort {
+
+const size_t MAX_FANIN = 64;
+
+// Column col of a CSV line (plain comma split, like the loaders).
+inline std::string_view csvField(std::string_view line, int col) {
+    size_t b = 0;
+    for (int c = 0; c < col; ++c) {
+        size_t p = line.find(',', b);
+        if (p == std::string_view::npos) return std::string_view();
+        b = p + 1;
+    }
+    size_t e = line.find(',', b);
+    return line.substr(b, e == std::string_view::npos ? std::string_view::npos : e - b);
+}
+
+// One data line plus its sort keys, located once when the line is read.
+struct Record {
+    std::string line;
+    uint32_t    off[MAX_SORT_KEYS] = { 0 };
+    uint32_t    len[MAX_SORT_KEYS] = { 0 };
+    double      num[MAX_SORT_KEYS] = { 0 };   // numeric columns, as sortNumber
+
+    std::string_view key(size_t i) const { return std::string_view(line).substr(off[i], len[i]); }
+    size_t bytes() const { return sizeof(Record) + line.capacity(); }
+};
+
+class RecordOrder {
+    std::vector<SortKey> keys;
+
+public:
+    explicit RecordOrder(std::vector<SortKey> k) : keys(std::move(k)) {}
+
+    void bind(Record& r) const {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            std::string_view v = csvField(r.line, int(keys[i].field));
+            r.off[i] = v.data() ? uint32_t(v.data() - r.line.data()) : 0;
+            r.len[i] = uint32_t(v.size());
+            r.num[i] = ordersAsNumber(keys[i].field) ? sortNumber(keys[i].field, v) : 0;
+        }
+    }
+
+    int compare(const Record& a, const Record& b) const {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            int c;
+            if (ordersAsNumber(keys[i].field)) c = compare3(a.num[i], b.num[i]);
+            else {
+                c = a.key(i).compare(b.key(i));
+                c = (c > 0) - (c < 0);
+            }
+            if (c) return keys[i].desc ? -c : c;
+        }
+        return 0;
+    }
+};
+
+// Sequential reader of one sorted run.
+class RunReader {
+    std::ifstream      in;
+    const RecordOrder* order;
+
+public:
+    Record cur;
+    bool   live = false;
+
+    RunReader(const std::string& path, const RecordOrder& o) : in(path), order(&o) { next(); }
+
+    void next() {
+        live = bool(std::getline(in, cur.line));
+        if (live) order->bind(cur);
+    }
+};
+
+// ------------------------------------------------------------------
+// Tournament tree over k sources: tree[0] holds the current winner and
+// every other node the loser of the match played there, so after the
+// winner's source advances only its leaf-to-root path is replayed
+// (log2 k compares). Index k is a sentinel that beats everything and
+// only exists while the tree is being built.
+// ------------------------------------------------------------------
+template <class Beats>
+class LoserTree {
+    std::vector<int> tree;
+    int              k;
+    Beats            beats;   // beats(a, b): source a's head goes first
+
+    void adjust(int s) {
+        for (int t = (s + k) / 2; t > 0; t /= 2)
+            if (beats(tree[t], s)) std::swap(s, tree[t]);
+        tree[0] = s;
+    }
+
+public:
+    LoserTree(int sources, Beats b) : tree(std::max(sources, 1), sources), k(sources), beats(b) {
+        for (int s = k - 1; s >= 0; --s) adjust(s);
+    }
+
+    int  winner() const { return tree[0]; }
+    void replay()       { adjust(tree[0]); }
+};
+
+class ExternalSorter {
+public:
+    struct Stats {
+        size_t   rows   = 0;
+        size_t   runs   = 0;
+        size_t   passes = 0;       // merge passes, the final one included
+        uint64_t bytes  = 0;       // size of the sorted output
+        double   runMs  = 0;       // reading, sorting and spilling runs
+        double   mergeMs = 0;
+    };
+
+private:
+    RecordOrder                 order;
+    size_t                      budget;
+    std::filesystem::path       tempDir;
+    std::vector<std::string>    temps;
+    size_t                      tempSeq = 0;
+
+    std::string newTemp() {
+        std::string p = (tempDir / ("fraud-sort-" + std::to_string(::getpid()) + "-"
+                                    + std::to_string(tempSeq++) + ".run")).string();
+        temps.push_back(p);
+        return p;
+    }
+
+    std::string spill(std::vector<Record>& run) {
+        std::stable_sort(run.begin(), run.end(),
+                         [this](const Record& a, const Record& b){ return order.compare(a, b) < 0; });
+        std::string path = newTemp();
+        std::ofstream out(path);
+        for (const Record& r : run) out << r.line << '\n';
+        run.clear();
+        return path;
+    }
+
+    // Merges runs (given in input order) into out; onRow(bytes) after each line.
+    template <class OnRow>
+    void merge(const std::vector<std::string>& runs, std::ostream& out, OnRow onRow) {
+        std::vector<std::unique_ptr<RunReader>> src;
+        for (const auto& p : runs) src.emplace_back(new RunReader(p, order));
+        int k = int(src.size());
+        auto beats = [&](int a, int b) {
+            if (a == k) return true;
+            if (b == k) return false;
+            bool la = src[a]->live, lb = src[b]->live;
+            if (!la || !lb) return la || (!lb && a < b);
+            int c = order.compare(src[a]->cur, src[b]->cur);
+            return c ? c < 0 : a < b;   // ties: earlier run first (stable)
+        };
+        LoserTree<decltype(beats)> lt(k, beats);
+        while (k && src[lt.winner()]->live) {
+            RunReader& w = *src[lt.winner()];
+            out << w.cur.line << '\n';
+            onRow(w.cur.line.size() + 1);
+            w.next();
+            lt.replay();
+        }
+    }
+
+    void removeTemps(const std::vector<std::string>& paths) {
+        for (const auto& p : paths) std::filesystem::remove(p);
+    }
+
+public:
+    // tempDir "" = the system temp directory.
+    ExternalSorter(std::vector<SortKey> keys, size_t budgetBytes, const std::string& dir = "")
+      : order(std::move(keys)), budget(std::max<size_t>(budgetBytes, 1 << 20)),
+        tempDir(dir.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(dir)) {}
+
+    ~ExternalSorter() { removeTemps(temps); }
+
+    // Sorts the data lines of inPath into outPath; marks receives the byte
+    // offset of rows 0, rowsPerMark, 2*rowsPerMark, ... of the output.
+    Stats run(const std::string& inPath, const std::string& outPath,
+              size_t rowsPerMark, std::vector<uint64_t>& marks) {
+        Stats st;
+        marks.clear();
+        std::ifstream in(inPath);
+        if (!in.is_open()) throw std::runtime_error("Cannot open " + inPath);
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        std::string header;
+        std::getline(in, header);
+        std::vector<std::string> runs;
+        std::vector<Record> cur;
+        size_t used = 0;
+        Record r;
+        while (std::getline(in, r.line)) {
+            if (r.line.empty()) continue;
+            order.bind(r);
+            used += r.bytes();
+            cur.push_back(std::move(r));
+            r = Record();
+            ++st.rows;
+            if (used >= budget) { runs.push_back(spill(cur)); used = 0; }
+        }
+        if (!cur.empty() || runs.empty()) runs.push_back(spill(cur));
+        std::vector<Record>().swap(cur);
+        st.runs = runs.size();
+        auto t1 = std::chrono::high_resolution_clock::now();
+
+        while (runs.size() > MAX_FANIN) {
+            std::vector<std::string> next;
+            for (size_t i = 0; i < runs.size(); i += MAX_FANIN) {
+                std::vector<std::string> group(runs.begin() + i,
+                                               runs.begin() + std::min(runs.size(), i + MAX_FANIN));
+                std::string path = newTemp();
+                std::ofstream out(path);
+                merge(group, out, [](size_t){});
+                removeTemps(group);
+                next.push_back(path);
+            }
+            runs.swap(next);
+            ++st.passes;
+        }
+
+        std::ofstream out(outPath);
+        out << header << '\n';
+        uint64_t offset = header.size() + 1;
+        size_t   row    = 0;
+        merge(runs, out, [&](size_t bytes) {
+            if (row++ % rowsPerMark == 0) marks.push_back(offset);
+            offset += bytes;
+        });
+        removeTemps(runs);
+        ++st.passes;
+        st.bytes = offset;
+        auto t2 = std::chrono::high_resolution_clock::now();
+        st.runMs   = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        st.mergeMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        return st;
+    }
+};
+
+// ------------------------------------------------------------------
+// Sorted CSV on disk with its row marks: pages are read by seeking to
+// the nearest mark, so paging and export never load the whole file.
+// ------------------------------------------------------------------
+class SortedCsv {
+    std::string           file;
+    std::vector<uint64_t> marks;
+    size_t                perMark = 1;
+    size_t                count   = 0;
+
+public:
+    SortedCsv() = default;
+    SortedCsv(std::string path, std::vector<uint64_t> m, size_t rowsPerMark, size_t rows)
+      : file(std::move(path)), marks(std::move(m)), perMark(rowsPerMark), count(rows) {}
+
+    size_t             size() const { return count; }
+    const std::string& path() const { return file; }
+
+    // Data lines [first, first + n), clipped to the file.
+    std::vector<std::string> rows(size_t first, size_t n) const {
+        std::vector<std::string> out;
+        if (first >= count) return out;
+        std::ifstream in(file);
+        in.seekg(std::streamoff(marks[first / perMark]));
+        std::string line;
+        for (size_t skip = first % perMark; skip && std::getline(in, line); --skip) {}
+        while (out.size() < n && std::getline(in, line)) out.push_back(line);
+        return out;
+    }
+
+    // Calls f(line) for every data line, in order.
+    template <class F>
+    void forEach(F f) const {
+        std::ifstream in(file);
+        std::string line;
+        std::getline(in, line);   // header
+        while (std::getline(in, line)) f(line);
+    }
+};
+
+} // namespace extsort
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef EYTZINGER_HPP
+#define EYTZINGER_HPP
+
+#include "BitmapIndex.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Sorted keys stored in Eytzinger (BFS) order: node k has children 2k
+// and 2k+1, so the top levels of every search share a few cache lines
+// and the descendants four levels down sit in one line that can be
+// prefetched while the current comparison resolves.
+// ------------------------------------------------------------------
+template <class Key>
+class EytzingerArray {
+    static const uint32_t LINE = 64 / sizeof(Key);   // keys per cache line
+
+    std::vector<Key>      storage;
+    Key*                  b = nullptr;   // 1-based, b[1] is the root
+    std::vector<uint32_t> sortedPos;     // slot -> position in sorted order
+    uint32_t              n = 0;
+
+    void fill(const Key* sorted, uint32_t& i, uint32_t k) {
+        if (k > n) return;
+        fill(sorted, i, 2 * k);
+        b[k] = sorted[i];
+        sortedPos[k] = i++;
+        fill(sorted, i, 2 * k + 1);
+    }
+
+public:
+    void build(const Key* sorted, uint32_t count) {
+        n = count;
+        // over-allocate so b[LINE * k] starts a cache line
+        storage.assign(n + 1 + 2 * LINE, Key());
+        uintptr_t p = reinterpret_cast<uintptr_t>(storage.data());
+        b = reinterpret_cast<Key*>((p + 63) & ~uintptr_t(63));
+        sortedPos.assign(n + 1, count);
+        uint32_t i = 0;
+        fill(sorted, i, 1);
+    }
+
+    void clear() {
+        storage.clear();   storage.shrink_to_fit();
+        sortedPos.clear(); sortedPos.shrink_to_fit();
+        b = nullptr;
+        n = 0;
+    }
+
+    uint32_t size() const { return n; }
+
+    // Position of the first key >= x in sorted order (size() if none).
+    uint32_t lowerBound(const Key& x) const {
+        uint32_t k = 1;
+        while (k <= n) {
+            __builtin_prefetch(b + size_t(k) * LINE);
+            k = 2 * k + (b[k] < x);
+        }
+        k >>= __builtin_ffs(~k);   // undo the right turns taken after the answer
+        return k ? sortedPos[k] : n;
+    }
+
+    size_t memoryBytes() const {
+        return storage.capacity() * sizeof(Key) + sortedPos.capacity() * sizeof(uint32_t);
+    }
+};
+
+// ------------------------------------------------------------------
+// Sorted index over one categorical column. Rows are ordered by the
+// rank of their value in the sorted dictionary, so the search compares
+// 32-bit ranks instead of strings; equal values keep row order.
+// ------------------------------------------------------------------
+class EytzingerIndex {
+    std::vector<uint32_t>           keys;     // ranks, ascending
+    std::vector<uint32_t>           rowIds;
+    std::vector<uint32_t>           rankOfCode;
+    const BitmapIndex::Column*      col = nullptr;
+    EytzingerArray<uint32_t>        tree;
+    bool                            ready = false;
+
+public:
+    // Indexes the first n rows of c (all rows by default).
+    void build(const BitmapIndex::Column& c, uint32_t n = UINT32_MAX) {
+        col = &c;
+        n = std::min<uint32_t>(n, uint32_t(c.codes.size()));
+        std::vector<uint32_t> byValue = c.codesByValue();
+        rankOfCode.assign(byValue.size(), 0);
+        for (uint32_t r = 0; r < byValue.size(); ++r) rankOfCode[byValue[r]] = r;
+
+        std::vector<std::pair<uint32_t, uint32_t>> tmp(n);
+        for (uint32_t r = 0; r < n; ++r) tmp[r] = { rankOfCode[c.codes.at(r)], r };
+        std::sort(tmp.begin(), tmp.end());
+
+        keys.resize(n);
+        rowIds.resize(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            keys[i]   = tmp[i].first;
+            rowIds[i] = tmp[i].second;
+        }
+        tree.build(keys.data(), n);
+        ready = true;
+    }
+
+    void clear() {
+        keys.clear();       keys.shrink_to_fit();
+        rowIds.clear();     rowIds.shrink_to_fit();
+        rankOfCode.clear();
+        tree.clear();
+        col   = nullptr;
+        ready = false;
+    }
+
+    bool built() const { return ready; }
+
+    // Rank of v in the sorted dictionary, or -1 if v never occurs.
+    int64_t rankOf(const std::string& v) const {
+        auto it = col->codeOf.find(v);
+        return it == col->codeOf.end() ? -1 : int64_t(rankOfCode[it->second]);
+    }
+
+    // Positions [first, last) of rows whose value is v.
+    std::pair<size_t, size_t> range(const std::string& v) const {
+        int64_t rk = rankOf(v);
+        if (rk < 0) return { 0, 0 };
+        return { tree.lowerBound(uint32_t(rk)), tree.lowerBound(uint32_t(rk) + 1) };
+    }
+
+    const std::vector<uint32_t>& sortedKeys() const { return keys; }
+    const EytzingerArray<uint32_t>& layout()  const { return tree; }
+    uint32_t rowAt(size_t pos) const { return rowIds[pos]; }
+
+    size_t memoryBytes() const {
+        return (keys.capacity() + rowIds.capacity() + rankOfCode.capacity()) * sizeof(uint32_t)
+             + tree.memoryBytes();
+    }
+};
+
+#endif
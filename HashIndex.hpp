@@ -0,0 +1,92 @@
+#ifndef HASH_INDEX_HPP
+#define HASH_INDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Open-addressing (linear probing) hash index from a string column to
+// row ids. Slots hold only the row id and a 32-bit hash tag; the key
+// itself stays in the row and is compared only when the tag matches.
+// ------------------------------------------------------------------
+inline uint64_t hashString(const char* s, size_t len) {
+    uint64_t h = 1469598103934665603ull;               // FNV-1a
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<unsigned char>(s[i]);
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdull;          // murmur3 finalizer
+    h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+inline uint64_t hashString(const std::string& s) { return hashString(s.data(), s.size()); }
+
+class HashIndex {
+    static const uint32_t EMPTY = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint32_t row = EMPTY;
+        uint32_t tag = 0;
+    };
+
+    std::vector<Slot> slots;
+    uint64_t          mask = 0;
+    uint32_t          keys = 0;
+
+public:
+    // keyAt(row) returns the key string of a row. Load factor stays <= 0.5.
+    template <class KeyAt>
+    void build(uint32_t n, KeyAt keyAt) {
+        uint64_t cap = 16;
+        while (cap < uint64_t(n) * 2) cap <<= 1;
+        slots.assign(cap, Slot());
+        mask = cap - 1;
+        keys = n;
+        for (uint32_t r = 0; r < n; ++r) {
+            uint64_t h = hashString(keyAt(r));
+            uint64_t i = h & mask;
+            while (slots[i].row != EMPTY) i = (i + 1) & mask;
+            slots[i].row = r;
+            slots[i].tag = uint32_t(h >> 32);
+        }
+    }
+
+    void clear() {
+        slots.clear();
+        slots.shrink_to_fit();
+        mask = 0;
+        keys = 0;
+    }
+
+    bool     built() const { return !slots.empty(); }
+    uint32_t size()  const { return keys; }
+
+    // Calls f(row) for every row whose key equals key, in insertion order.
+    template <class KeyAt, class F>
+    void findAll(const std::string& key, KeyAt keyAt, F f) const {
+        if (slots.empty()) return;
+        uint64_t h   = hashString(key);
+        uint32_t tag = uint32_t(h >> 32);
+        for (uint64_t i = h & mask; slots[i].row != EMPTY; i = (i + 1) & mask)
+            if (slots[i].tag == tag && keyAt(slots[i].row) == key) f(slots[i].row);
+    }
+
+    // First matching row, or -1.
+    template <class KeyAt>
+    int64_t find(const std::string& key, KeyAt keyAt) const {
+        if (slots.empty()) return -1;
+        uint64_t h   = hashString(key);
+        uint32_t tag = uint32_t(h >> 32);
+        for (uint64_t i = h & mask; slots[i].row != EMPTY; i = (i + 1) & mask)
+            if (slots[i].tag == tag && keyAt(slots[i].row) == key) return slots[i].row;
+        return -1;
+    }
+
+    double loadFactor()  const { return slots.empty() ? 0 : double(keys) / slots.size(); }
+    size_t memoryBytes() const { return slots.capacity() * sizeof(Slot); }
+};
+
+#endif
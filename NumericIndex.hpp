@@ -0,0 +1,100 @@
+#ifndef NUMERIC_INDEX_HPP
+#define NUMERIC_INDEX_HPP
+
+#include "Bitmap.hpp"
+#include "Transaction.hpp"
+#include "TransactionFields.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Sorted numeric column: keys in ascending order next to the row id
+// they came from. A range [lo, hi] is two binary searches plus a
+// contiguous walk, i.e. O(log n + k).
+// ------------------------------------------------------------------
+class SortedNumericIndex {
+    std::vector<double>   keys;
+    std::vector<uint32_t> rowIds;
+    Field                 field = Field::amount;
+    bool                  ready = false;
+
+public:
+    template <class RowAt>
+    void build(Field f, uint32_t n, RowAt rowAt) {
+        std::vector<std::pair<double, uint32_t>> tmp(n);
+        for (uint32_t r = 0; r < n; ++r) tmp[r] = { numericField(rowAt(r), f), r };
+        std::sort(tmp.begin(), tmp.end());
+
+        keys.resize(n);
+        rowIds.resize(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            keys[i]   = tmp[i].first;
+            rowIds[i] = tmp[i].second;
+        }
+        field = f;
+        ready = true;
+    }
+
+    void clear() {
+        keys.clear();   keys.shrink_to_fit();
+        rowIds.clear(); rowIds.shrink_to_fit();
+        ready = false;
+    }
+
+    bool  built()   const { return ready; }
+    Field column()  const { return field; }
+    size_t size()   const { return keys.size(); }
+
+    // Positions [first, last) of keys inside the bounds.
+    std::pair<size_t, size_t> range(bool hasLo, double lo, bool loIncl,
+                                     bool hasHi, double hi, bool hiIncl) const {
+        size_t first = 0, last = keys.size();
+        if (hasLo) first = size_t((loIncl ? std::lower_bound(keys.begin(), keys.end(), lo)
+                                          : std::upper_bound(keys.begin(), keys.end(), lo))
+                                  - keys.begin());
+        if (hasHi) last  = size_t((hiIncl ? std::upper_bound(keys.begin(), keys.end(), hi)
+                                          : std::lower_bound(keys.begin(), keys.end(), hi))
+                                  - keys.begin());
+        if (last < first) last = first;
+        return { first, last };
+    }
+
+    uint32_t rowAt(size_t pos) const { return rowIds[pos]; }
+    double   keyAt(size_t pos) const { return keys[pos]; }
+
+    // Row ids of positions [first, last) as a bitmap (ascending row order).
+    Bitmap toBitmap(std::pair<size_t, size_t> pr) const {
+        std::vector<uint32_t> ids(rowIds.begin() + pr.first, rowIds.begin() + pr.second);
+        std::sort(ids.begin(), ids.end());
+        Bitmap b;
+        for (uint32_t r : ids) b.add(r);
+        return b;
+    }
+
+    size_t memoryBytes() const {
+        return keys.capacity() * sizeof(double) + rowIds.capacity() * sizeof(uint32_t);
+    }
+};
+
+// One lazily built sorted index per numeric column.
+struct NumericIndexes {
+    SortedNumericIndex byField[FIELD_COUNT];
+
+    static bool supported(Field f) { return isNumeric(f); }
+
+    SortedNumericIndex&       operator[](Field f)       { return byField[static_cast<int>(f)]; }
+    const SortedNumericIndex& operator[](Field f) const { return byField[static_cast<int>(f)]; }
+
+    void clear() { for (auto& x : byField) x.clear(); }
+
+    size_t memoryBytes() const {
+        size_t b = 0;
+        for (const auto& x : byField) b += x.memoryBytes();
+        return b;
+    }
+};
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef PARALLEL_SORT_HPP
+#define PARALLEL_SORT_HPP
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Stable merge sort over a caller-owned scratch buffer of the same
+// length, split across the pool. The input is cut into one run per
+// task (never shorter than MERGE_CUTOFF), runs are sorted
+// independently, then merged pairwise level by level. When a level has
+// fewer merges than workers, each merge is cut along its merge path
+// into equal output slices so the last levels stay parallel too.
+// ------------------------------------------------------------------
+namespace psort {
+
+const size_t MERGE_CUTOFF      = size_t(1) << 14;   // smallest run handed to one task
+const size_t QUICK_TASK_CUTOFF = size_t(1) << 13;   // smaller partitions stay on one worker
+const size_t NINTHER_CUTOFF    = 128;               // median-of-3 below, ninther above
+const size_t INSERTION_CUTOFF  = 32;
+
+template <class T, class Less>
+void insertionSort(T* a, size_t n, Less less) {
+    for (size_t i = 1; i < n; ++i) {
+        T v = a[i];
+        size_t j = i;
+        for (; j > 0 && less(v, a[j-1]); --j) a[j] = a[j-1];
+        a[j] = v;
+    }
+}
+
+// Stable merge of a[0, la) and b[0, lb) into out; ties take from a.
+template <class T, class Less>
+void mergeRuns(const T* a, size_t la, const T* b, size_t lb, T* out, Less less) {
+    size_t i = 0, j = 0;
+    while (i < la && j < lb) *out++ = less(b[j], a[i]) ? b[j++] : a[i++];
+    out = std::copy(a + i, a + la, out);
+    std::copy(b + j, b + lb, out);
+}
+
+// Number of elements of a among the first k outputs of mergeRuns(a, b).
+template <class T, class Less>
+size_t coRank(size_t k, const T* a, size_t la, const T* b, size_t lb, Less less) {
+    size_t lo = k > lb ? k - lb : 0, hi = std::min(k, la);
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (!less(b[k - i - 1], a[i])) lo = i + 1;   // a[i] still precedes b[k-i-1]
+        else                           hi = i;
+    }
+    return lo;
+}
+
+// Sequential top-down sort of a[0, n) using tmp[0, n).
+template <class T, class Less>
+void mergeSortSeq(T* a, T* tmp, size_t n, Less less) {
+    if (n <= INSERTION_CUTOFF) { insertionSort(a, n, less); return; }
+    size_t m = n / 2;
+    mergeSortSeq(a,     tmp,     m,     less);
+    mergeSortSeq(a + m, tmp + m, n - m, less);
+    if (!less(a[m], a[m-1])) return;                 // already in order
+    mergeRuns(a, m, a + m, n - m, tmp, less);
+    std::copy(tmp, tmp + n, a);
+}
+
+template <class T, class Less>
+void parallelMergeSort(T* data, T* scratch, size_t n, Less less, ThreadPool& pool) {
+    size_t workers = pool.size();
+    size_t runs = std::max<size_t>(1, std::min(workers * 4, n / MERGE_CUTOFF));
+    if (workers == 1) runs = 1;
+
+    std::vector<size_t> bound(runs + 1);
+    for (size_t r = 0; r <= runs; ++r) bound[r] = n * r / runs;
+    pool.parallelFor(runs, runs, [&](size_t r, size_t, size_t) {
+        mergeSortSeq(data + bound[r], scratch + bound[r], bound[r+1] - bound[r], less);
+    });
+
+    T* src = data;
+    T* dst = scratch;
+    while (bound.size() > 2) {
+        size_t pairs = (bound.size() - 1) / 2;
+        bool   odd   = (bound.size() - 1) % 2 == 1;
+        size_t slices = std::max<size_t>(1, (workers * 2 + pairs - 1) / pairs);
+        pool.parallelFor(pairs * slices, pairs * slices, [&](size_t t, size_t, size_t) {
+            size_t p = t / slices, s = t % slices;
+            size_t lo = bound[2*p], mid = bound[2*p + 1], hi = bound[2*p + 2];
+            const T* a = src + lo;  size_t la = mid - lo;
+            const T* b = src + mid; size_t lb = hi - mid;
+            size_t k0 = (la + lb) * s / slices, k1 = (la + lb) * (s + 1) / slices;
+            size_t i0 = coRank(k0, a, la, b, lb, less), i1 = coRank(k1, a, la, b, lb, less);
+            mergeRuns(a + i0, i1 - i0, b + (k0 - i0), (k1 - i1) - (k0 - i0), dst + lo + k0, less);
+        });
+        if (odd) std::copy(src + bound[bound.size() - 2], src + n, dst + bound[bound.size() - 2]);
+
+        std::vector<size_t> next;
+        for (size_t r = 0; r < bound.size(); r += 2) next.push_back(bound[r]);
+        if (next.back() != n) next.push_back(n);
+        bound.swap(next);
+        std::swap(src, dst);
+    }
+
+    if (src != data) {
+        size_t chunks = workers;
+        pool.parallelFor(n, chunks, [&](size_t, size_t b, size_t e) {
+            std::copy(src + b, src + e, data + b);
+        });
+    }
+}
+
+// ------------------------------------------------------------------
+// 3-way (Dijkstra) quicksort. cmp(x, y) returns <0, 0 or >0, so each
+// element costs one comparison per partition; the pivot is an element
+// value (a row id for index sorts), never a copy of the key. Runs of
+// equal keys collapse into one block per partition, and the pivot is a
+// median of samples, so sorted and low-cardinality input stay n log n.
+// ------------------------------------------------------------------
+template <class T, class Cmp>
+const T& median3(const T& a, const T& b, const T& c, Cmp cmp) {
+    if (cmp(a, b) < 0) return cmp(b, c) < 0 ? b : (cmp(a, c) < 0 ? c : a);
+    return cmp(a, c) < 0 ? a : (cmp(b, c) < 0 ? c : b);
+}
+
+// Median of three, or Tukey's ninther on larger ranges.
+template <class T, class Cmp>
+T choosePivot(const T* a, size_t n, Cmp cmp) {
+    size_t m = n / 2;
+    if (n < NINTHER_CUTOFF) return median3(a[0], a[m], a[n-1], cmp);
+    size_t s = n / 8;
+    return median3(median3(a[0],         a[s],     a[2*s],   cmp),
+                   median3(a[m-s],       a[m],     a[m+s],   cmp),
+                   median3(a[n-1-2*s],   a[n-1-s], a[n-1],   cmp), cmp);
+}
+
+// Partitions a[0, n) into < pivot, == pivot, > pivot; returns the
+// bounds [lt, gt) of the equal block.
+template <class T, class Cmp>
+std::pair<size_t, size_t> partition3(T* a, size_t n, T pivot, Cmp cmp) {
+    size_t lt = 0, i = 0, gt = n;
+    while (i < gt) {
+        int c = cmp(a[i], pivot);
+        if      (c < 0) std::swap(a[lt++], a[i++]);
+        else if (c > 0) std::swap(a[i],    a[--gt]);
+        else            ++i;
+    }
+    return { lt, gt };
+}
+
+// Partition budget of an introsort over n elements: 2 * floor(log2 n).
+inline int depthLimit(size_t n) {
+    int d = 0;
+    while (n > 1) { n >>= 1; d += 2; }
+    return d;
+}
+
+// Fallback once the partition budget is spent: O(n log n) whatever the input.
+template <class T, class Cmp>
+void heapSort(T* a, size_t n, Cmp cmp) {
+    auto less = [&](const T& x, const T& y){ return cmp(x, y) < 0; };
+    std::make_heap(a, a + n, less);
+    std::sort_heap(a, a + n, less);
+}
+
+// Introsort: recurses into the smaller side and loops on the larger, so
+// the stack stays O(log n); a range still unsorted after `depth`
+// partitions (pivots kept landing near the ends) is heap-sorted.
+template <class T, class Cmp>
+void quickSort3(T* a, size_t n, Cmp cmp, int depth) {
+    while (n > INSERTION_CUTOFF) {
+        if (depth-- == 0) { heapSort(a, n, cmp); return; }
+        auto eq = partition3(a, n, choosePivot(a, n, cmp), cmp);
+        size_t ln = eq.first, rn = n - eq.second;
+        if (ln < rn) { quickSort3(a, ln, cmp, depth); a += eq.second; n = rn; }
+        else         { quickSort3(a + eq.second, rn, cmp, depth); n = ln; }
+    }
+    insertionSort(a, n, [&](const T& x, const T& y){ return cmp(x, y) < 0; });
+}
+
+template <class T, class Cmp>
+void quickSort3(T* a, size_t n, Cmp cmp) { quickSort3(a, n, cmp, depthLimit(n)); }
+
+// Each partition above QUICK_TASK_CUTOFF hands its left side to the
+// pool as a task and keeps partitioning the right side itself. Tasks
+// carry the remaining partition budget, as in quickSort3.
+template <class T, class Cmp>
+void parallelQuickSort(T* a, size_t n, Cmp cmp, WorkStealingPool& pool) {
+    if (pool.size() == 1 || n < QUICK_TASK_CUTOFF) { quickSort3(a, n, cmp); return; }
+    std::function<void(T*, size_t, int)> task = [&](T* b, size_t m, int depth) {
+        while (m >= QUICK_TASK_CUTOFF) {
+            if (depth-- == 0) { heapSort(b, m, cmp); return; }
+            auto eq = partition3(b, m, choosePivot(b, m, cmp), cmp);
+            size_t ln = eq.first;
+            if (ln) pool.spawn([&task, b, ln, depth]{ task(b, ln, depth); });
+            b += eq.second;
+            m -= eq.second;
+        }
+        quickSort3(b, m, cmp, depth);
+    };
+    pool.run([&]{ task(a, n, depthLimit(n)); });
+}
+
+} // namespace psort
+
+#endif
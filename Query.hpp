@@ -0,0 +1,534 @@
+#ifndef QUERY_HPP
+#define QUERY_HPP
+
+#include "Bitmap.hpp"
+#include "BitmapIndex.hpp"
+#include "HashIndex.hpp"
+#include "NumericIndex.hpp"
+#include "Transaction.hpp"
+#include "TransactionFields.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Small query engine over Transaction rows.
+//
+//   query := term  { OR term }
+//   term  := factor { AND factor }
+//   factor:= '(' query ')' | field op
+//   op    := '=' v | IN '(' v {',' v} ')' | PREFIX v
+//          | '<' v | '<=' v | '>' v | '>=' v | BETWEEN v AND v
+//
+// Values are bare words or quoted strings. Numeric columns compare as
+// numbers, other columns compare as strings.
+//
+// The planner annotates every node with an access path (bitmap index,
+// id hash lookup, sorted numeric range, or scan) and a row estimate.
+// AND children are executed most-selective first, and scan predicates
+// are pushed down into a single pass over the surviving candidate rows
+// instead of being applied after materialization.
+// ------------------------------------------------------------------
+
+struct Predicate {
+    enum Op { EQ, IN, RANGE, PREFIX };
+
+    Field                    field = Field::transaction_id;
+    Op                       op    = EQ;
+    std::vector<std::string> values;        // EQ / IN / PREFIX
+    std::string              loText, hiText; // RANGE bounds as written
+    double                   lo = 0, hi = 0;
+    bool                     hasLo = false, hasHi = false;
+    bool                     loIncl = true, hiIncl = true;
+
+    static double toNumber(const std::string& s) {
+        return s.empty() ? 0.0 : std::strtod(s.c_str(), nullptr);
+    }
+
+    bool numericRange() const {
+        return ordersAsNumber(field);
+    }
+
+    template <class T>
+    bool inRange(const T& v, const T& l, const T& h) const {
+        if (hasLo && (loIncl ? v < l : !(l < v))) return false;
+        if (hasHi && (hiIncl ? h < v : !(v < h))) return false;
+        return true;
+    }
+
+    bool matches(const Transaction& t) const {
+        if (op == RANGE) {
+            if (numericRange()) {
+                double v = isNumeric(field) ? numericField(t, field)
+                                            : toNumber(*stringField(t, field));
+                return inRange(v, lo, hi);
+            }
+            return inRange(fieldText(t, field), loText, hiText);
+        }
+        const std::string* s = stringField(t, field);
+        std::string tmp;
+        if (!s) { tmp = fieldText(t, field); s = &tmp; }
+        if (op == PREFIX) return s->compare(0, values[0].size(), values[0]) == 0;
+        if (isNumeric(field)) {
+            double v = numericField(t, field);
+            for (const auto& x : values) if (v == toNumber(x)) return true;
+            return false;
+        }
+        for (const auto& x : values) if (*s == x) return true;
+        return false;
+    }
+
+    std::string toString() const {
+        std::string r = fieldName(field);
+        switch (op) {
+        case EQ:     return r + " = '" + values[0] + "'";
+        case PREFIX: return r + " PREFIX '" + values[0] + "'";
+        case IN: {
+            r += " IN (";
+            for (size_t i = 0; i < values.size(); ++i) r += (i ? ", '" : "'") + values[i] + "'";
+            return r + ")";
+        }
+        case RANGE:
+            if (hasLo && hasHi) return r + " BETWEEN " + loText + " AND " + hiText;
+            if (hasLo)          return r + (loIncl ? " >= " : " > ") + loText;
+            return r + (hiIncl ? " <= " : " < ") + hiText;
+        }
+        return r;
+    }
+};
+
+enum class AccessPath { INDEX, HASH, SORTED_RANGE, SCAN };
+
+inline const char* accessPathName(AccessPath p) {
+    switch (p) {
+    case AccessPath::INDEX:        return "index";
+    case AccessPath::HASH:         return "hash-lookup";
+    case AccessPath::SORTED_RANGE: return "sorted-range";
+    default:                       return "scan";
+    }
+}
+
+struct QueryNode {
+    enum Kind { PRED, AND, OR };
+
+    Kind                                    kind = PRED;
+    Predicate                               pred;
+    std::vector<std::unique_ptr<QueryNode>> kids;
+
+    // filled in by the planner
+    AccessPath path    = AccessPath::SCAN;
+    double     estRows = 0;
+    Bitmap     hashRows;    // HASH: rows probed while planning, reused by eval
+};
+
+// ------------------------------------------------------------------
+// parser
+// ------------------------------------------------------------------
+class QueryParser {
+    struct Token {
+        enum Kind { WORD, STRING, SYM, END } kind;
+        std::string text;
+    };
+
+    std::vector<Token> toks;
+    size_t             pos = 0;
+
+    static bool isSymChar(char c) {
+        return c == '(' || c == ')' || c == ',' || c == '=' || c == '<' || c == '>';
+    }
+
+    static std::string upper(std::string s) {
+        std::transform(s.begin(), s.end(), s.begin(), ::toupper);
+        return s;
+    }
+
+    void tokenize(const std::string& q) {
+        size_t i = 0;
+        while (i < q.size()) {
+            char c = q[i];
+            if (std::isspace(static_cast<unsigned char>(c))) { ++i; continue; }
+            if (c == '\'' || c == '"') {
+                size_t j = q.find(c, i + 1);
+                if (j == std::string::npos) throw std::runtime_error("Unterminated quote in query");
+                toks.push_back({Token::STRING, q.substr(i + 1, j - i - 1)});
+                i = j + 1;
+            } else if (c == '<' || c == '>') {
+                bool eq = i + 1 < q.size() && q[i + 1] == '=';
+                toks.push_back({Token::SYM, std::string(1, c) + (eq ? "=" : "")});
+                i += eq ? 2 : 1;
+            } else if (isSymChar(c)) {
+                toks.push_back({Token::SYM, std::string(1, c)});
+                ++i;
+            } else {
+                size_t j = i;
+                while (j < q.size() && !std::isspace(static_cast<unsigned char>(q[j]))
+                       && !isSymChar(q[j]) && q[j] != '\'' && q[j] != '"') ++j;
+                toks.push_back({Token::WORD, q.substr(i, j - i)});
+                i = j;
+            }
+        }
+        toks.push_back({Token::END, ""});
+    }
+
+    const Token& peek() const { return toks[pos]; }
+
+    bool acceptKeyword(const char* kw) {
+        if (peek().kind == Token::WORD && upper(peek().text) == kw) { ++pos; return true; }
+        return false;
+    }
+
+    bool acceptSym(const char* s) {
+        if (peek().kind == Token::SYM && peek().text == s) { ++pos; return true; }
+        return false;
+    }
+
+    void expectSym(const char* s) {
+        if (!acceptSym(s))
+            throw std::runtime_error(std::string("Expected '") + s + "' near '" + peek().text + "'");
+    }
+
+    std::string value(Field f) {
+        const Token& t = peek();
+        if (t.kind != Token::WORD && t.kind != Token::STRING)
+            throw std::runtime_error("Expected a value near '" + t.text + "'");
+        ++pos;
+        std::string v = t.text;
+        if (f == Field::is_fraud) {
+            std::transform(v.begin(), v.end(), v.begin(), ::tolower);
+            v = (v == "true" || v == "1" || v == "yes") ? "true" : "false";
+        }
+        return v;
+    }
+
+    void setBound(Predicate& p, bool low, bool incl, const std::string& v) {
+        if (low) { p.hasLo = true; p.loIncl = incl; p.loText = v; p.lo = Predicate::toNumber(v); }
+        else     { p.hasHi = true; p.hiIncl = incl; p.hiText = v; p.hi = Predicate::toNumber(v); }
+    }
+
+    std::unique_ptr<QueryNode> parsePredicate() {
+        if (peek().kind != Token::WORD)
+            throw std::runtime_error("Expected a field name near '" + peek().text + "'");
+        std::string name = peek().text;
+        ++pos;
+
+        auto node = std::make_unique<QueryNode>();
+        Predicate& p = node->pred;
+        if (!fieldFromName(name, p.field))
+            throw std::runtime_error("Unknown field '" + name + "'");
+
+        if (acceptSym("=")) {
+            p.op = Predicate::EQ;
+            p.values.push_back(value(p.field));
+        } else if (acceptKeyword("IN")) {
+            p.op = Predicate::IN;
+            expectSym("(");
+            do { p.values.push_back(value(p.field)); } while (acceptSym(","));
+            expectSym(")");
+        } else if (acceptKeyword("PREFIX")) {
+            p.op = Predicate::PREFIX;
+            p.values.push_back(value(p.field));
+        } else if (acceptKeyword("BETWEEN")) {
+            p.op = Predicate::RANGE;
+            setBound(p, true, true, value(p.field));
+            if (!acceptKeyword("AND")) throw std::runtime_error("Expected AND in BETWEEN");
+            setBound(p, false, true, value(p.field));
+        } else if (acceptSym(">=")) { p.op = Predicate::RANGE; setBound(p, true,  true,  value(p.field)); }
+        else if   (acceptSym(">"))  { p.op = Predicate::RANGE; setBound(p, true,  false, value(p.field)); }
+        else if   (acceptSym("<=")) { p.op = Predicate::RANGE; setBound(p, false, true,  value(p.field)); }
+        else if   (acceptSym("<"))  { p.op = Predicate::RANGE; setBound(p, false, false, value(p.field)); }
+        else throw std::runtime_error("Expected an operator after '" + name + "'");
+
+        if (p.op == Predicate::IN && p.values.size() == 1) p.op = Predicate::EQ;
+        return node;
+    }
+
+    std::unique_ptr<QueryNode> parseFactor() {
+        if (acceptSym("(")) {
+            auto n = parseOr();
+            expectSym(")");
+            return n;
+        }
+        return parsePredicate();
+    }
+
+    std::unique_ptr<QueryNode> parseList(QueryNode::Kind kind) {
+        auto first = kind == QueryNode::AND ? parseFactor() : parseList(QueryNode::AND);
+        const char* kw = kind == QueryNode::AND ? "AND" : "OR";
+        if (!(peek().kind == Token::WORD && upper(peek().text) == kw)) return first;
+
+        auto node = std::make_unique<QueryNode>();
+        node->kind = kind;
+        node->kids.push_back(std::move(first));
+        while (acceptKeyword(kw))
+            node->kids.push_back(kind == QueryNode::AND ? parseFactor() : parseList(QueryNode::AND));
+        return node;
+    }
+
+    std::unique_ptr<QueryNode> parseOr() { return parseList(QueryNode::OR); }
+
+public:
+    static std::unique_ptr<QueryNode> parse(const std::string& text) {
+        QueryParser p;
+        p.tokenize(text);
+        if (p.peek().kind == Token::END) throw std::runtime_error("Empty query");
+        auto root = p.parseOr();
+        if (p.peek().kind != Token::END)
+            throw std::runtime_error("Unexpected '" + p.peek().text + "' in query");
+        return root;
+    }
+};
+
+// ------------------------------------------------------------------
+// planner + executor
+// ------------------------------------------------------------------
+
+// Indexes a store can offer to the planner; any of them may be absent.
+struct QueryIndexes {
+    const BitmapIndex*    bitmaps = nullptr;
+    const NumericIndexes* numeric = nullptr;
+    const HashIndex*      ids     = nullptr;   // transaction_id
+};
+
+// Numeric columns a query would like a sorted index for, so the store can
+// build them before planning.
+inline void collectNumericFields(const QueryNode& node, std::vector<Field>& out) {
+    if (node.kind == QueryNode::PRED) {
+        if (NumericIndexes::supported(node.pred.field) && node.pred.op != Predicate::PREFIX
+            && std::find(out.begin(), out.end(), node.pred.field) == out.end())
+            out.push_back(node.pred.field);
+        return;
+    }
+    for (const auto& k : node.kids) collectNumericFields(*k, out);
+}
+
+template <class RowAt>
+class QueryEngine {
+    QueryIndexes idx;
+    uint32_t     n;
+    RowAt        rowAt;
+
+    static const uint32_t SAMPLE = 1024;
+
+    // Dictionary values of a categorical column that satisfy p.
+    std::vector<std::string> dictionaryMatches(const Predicate& p) const {
+        if (p.op == Predicate::EQ || p.op == Predicate::IN) return p.values;
+        std::vector<std::string> out;
+        for (const auto& v : idx.bitmaps->column(p.field).values) {
+            if (p.op == Predicate::PREFIX) {
+                if (v.compare(0, p.values[0].size(), p.values[0]) == 0) out.push_back(v);
+            } else if (!p.numericRange() && p.inRange(v, p.loText, p.hiText)) {
+                out.push_back(v);
+            }
+        }
+        return out;
+    }
+
+    const SortedNumericIndex* sortedFor(const Predicate& p) const {
+        if (!idx.numeric || !NumericIndexes::supported(p.field) || p.op == Predicate::PREFIX)
+            return nullptr;
+        const SortedNumericIndex& s = (*idx.numeric)[p.field];
+        return s.built() ? &s : nullptr;
+    }
+
+    // Sorted-index position ranges covering p (one per IN value).
+    std::vector<std::pair<size_t, size_t>> sortedRanges(const SortedNumericIndex& s,
+                                                        const Predicate& p) const {
+        std::vector<std::pair<size_t, size_t>> out;
+        if (p.op == Predicate::RANGE) {
+            out.push_back(s.range(p.hasLo, p.lo, p.loIncl, p.hasHi, p.hi, p.hiIncl));
+        } else {
+            for (const auto& v : p.values) {
+                double x = Predicate::toNumber(v);
+                out.push_back(s.range(true, x, true, true, x, true));
+            }
+        }
+        return out;
+    }
+
+    bool hashable(const Predicate& p) const {
+        return idx.ids && idx.ids->built() && p.field == Field::transaction_id
+            && (p.op == Predicate::EQ || p.op == Predicate::IN);
+    }
+
+    Bitmap hashLookup(const Predicate& p) const {
+        auto keyAt = [this](uint32_t r) -> const std::string& { return rowAt(r).transaction_id; };
+        std::vector<uint32_t> found;
+        for (const auto& v : p.values)
+            idx.ids->findAll(v, keyAt, [&](uint32_t r){ found.push_back(r); });
+        std::sort(found.begin(), found.end());
+        Bitmap b;
+        for (uint32_t r : found) b.add(r);
+        return b;
+    }
+
+    bool indexable(const Predicate& p) const {
+        if (!idx.bitmaps || !isCategorical(p.field)) return false;
+        return p.op != Predicate::RANGE || !p.numericRange();
+    }
+
+    double sampleSelectivity(const QueryNode& node) const {
+        if (!n) return 0;
+        uint32_t step  = std::max<uint32_t>(1, n / SAMPLE);
+        uint32_t seen  = 0, hits = 0;
+        for (uint32_t r = 0; r < n; r += step, ++seen)
+            if (matchRow(node, rowAt(r))) ++hits;
+        // never estimate zero from a sample: the row may still exist
+        return std::max(double(hits), 0.5) / seen;
+    }
+
+    void plan(QueryNode& node) const {
+        if (node.kind == QueryNode::PRED) {
+            if (indexable(node.pred)) {
+                node.path = AccessPath::INDEX;
+                double rows = 0;
+                for (const auto& v : dictionaryMatches(node.pred))
+                    if (const Bitmap* b = idx.bitmaps->column(node.pred.field).find(v))
+                        rows += double(b->cardinality());
+                node.estRows = rows;
+            } else if (hashable(node.pred)) {
+                node.path     = AccessPath::HASH;
+                node.hashRows = hashLookup(node.pred);
+                node.estRows  = double(node.hashRows.cardinality());
+            } else if (const SortedNumericIndex* s = sortedFor(node.pred)) {
+                node.path = AccessPath::SORTED_RANGE;
+                double rows = 0;
+                for (const auto& pr : sortedRanges(*s, node.pred)) rows += double(pr.second - pr.first);
+                node.estRows = rows;
+            } else {
+                node.path    = AccessPath::SCAN;
+                node.estRows = sampleSelectivity(node) * n;
+            }
+            return;
+        }
+
+        for (auto& k : node.kids) plan(*k);
+
+        // bitmap-producing children first, each group most selective first
+        std::stable_sort(node.kids.begin(), node.kids.end(),
+            [](const std::unique_ptr<QueryNode>& a, const std::unique_ptr<QueryNode>& b) {
+                bool ai = a->path != AccessPath::SCAN, bi = b->path != AccessPath::SCAN;
+                if (ai != bi) return ai;
+                return a->estRows < b->estRows;
+            });
+
+        bool allIndexed = true;
+        double sel = node.kind == QueryNode::AND ? 1.0 : 0.0;
+        for (const auto& k : node.kids) {
+            double ks = n ? k->estRows / n : 0;
+            if (node.kind == QueryNode::AND) sel *= ks;
+            else                             sel  = std::min(1.0, sel + ks);
+            if (k->path == AccessPath::SCAN) allIndexed = false;
+        }
+        node.estRows = sel * n;
+        bool anyIndexed = node.kids.front()->path != AccessPath::SCAN;
+        node.path = (node.kind == QueryNode::AND ? anyIndexed : allIndexed)
+                  ? AccessPath::INDEX : AccessPath::SCAN;
+    }
+
+    bool matchRow(const QueryNode& node, const Transaction& t) const {
+        switch (node.kind) {
+        case QueryNode::PRED: return node.pred.matches(t);
+        case QueryNode::AND:
+            for (const auto& k : node.kids) if (!matchRow(*k, t)) return false;
+            return true;
+        default:
+            for (const auto& k : node.kids) if (matchRow(*k, t)) return true;
+            return false;
+        }
+    }
+
+    // One pass over the candidates (or all rows) applying the filters.
+    Bitmap scan(const std::vector<const QueryNode*>& filters, const Bitmap* cand) const {
+        Bitmap out;
+        auto test = [&](uint32_t r) {
+            const Transaction& t = rowAt(r);
+            for (const QueryNode* f : filters) if (!matchRow(*f, t)) return;
+            out.add(r);
+        };
+        if (cand) cand->forEach(test);
+        else      for (uint32_t r = 0; r < n; ++r) test(r);
+        return out;
+    }
+
+    Bitmap eval(const QueryNode& node, const Bitmap* cand) const {
+        if (node.kind == QueryNode::PRED) {
+            if (node.path == AccessPath::INDEX) {
+                Bitmap b = idx.bitmaps->lookup(node.pred.field, dictionaryMatches(node.pred));
+                return cand ? (b & *cand) : b;
+            }
+            if (node.path == AccessPath::HASH)
+                return cand ? (node.hashRows & *cand) : node.hashRows;
+            if (node.path == AccessPath::SORTED_RANGE) {
+                const SortedNumericIndex& s = *sortedFor(node.pred);
+                Bitmap b;
+                for (const auto& pr : sortedRanges(s, node.pred)) b |= s.toBitmap(pr);
+                return cand ? (b & *cand) : b;
+            }
+            return scan({&node}, cand);
+        }
+
+        if (node.kind == QueryNode::OR) {
+            if (node.path == AccessPath::SCAN) return scan({&node}, cand);
+            Bitmap acc;
+            for (const auto& k : node.kids) acc |= eval(*k, cand);
+            return acc;
+        }
+
+        // AND: intersect index-backed children, then push the remaining
+        // predicates down into one scan over the surviving rows.
+        Bitmap acc;
+        bool   have = cand != nullptr;
+        if (cand) acc = *cand;
+        std::vector<const QueryNode*> filters;
+        for (const auto& k : node.kids) {
+            if (k->path == AccessPath::SCAN) { filters.push_back(k.get()); continue; }
+            // a wide range is cheaper to test on a few candidates than to materialize
+            if (k->path == AccessPath::SORTED_RANGE && have
+                && double(acc.cardinality()) < k->estRows) {
+                filters.push_back(k.get());
+                continue;
+            }
+            acc  = eval(*k, have ? &acc : nullptr);
+            have = true;
+            if (acc.empty()) return acc;
+        }
+        if (filters.empty()) return acc;
+        return scan(filters, have ? &acc : nullptr);
+    }
+
+    void explain(const QueryNode& node, int depth, std::ostringstream& os) const {
+        os << std::string(depth * 2, ' ');
+        if (node.kind == QueryNode::PRED) os << node.pred.toString();
+        else                              os << (node.kind == QueryNode::AND ? "AND" : "OR");
+        os << "  [" << accessPathName(node.path) << ", est " << uint64_t(node.estRows + 0.5)
+           << " rows]\n";
+        for (const auto& k : node.kids) explain(*k, depth + 1, os);
+    }
+
+public:
+    QueryEngine(const QueryIndexes& ix, uint32_t rows, RowAt at)
+      : idx(ix), n(rows), rowAt(at) {}
+
+    // Plans the tree in place and returns a printable plan.
+    std::string prepare(QueryNode& root) const {
+        plan(root);
+        std::ostringstream os;
+        explain(root, 0, os);
+        return os.str();
+    }
+
+    Bitmap execute(const QueryNode& root) const { return eval(root, nullptr); }
+};
+
+template <class RowAt>
+QueryEngine<RowAt> makeQueryEngine(const QueryIndexes& ix, uint32_t rows, RowAt at) {
+    return QueryEngine<RowAt>(ix, rows, at);
+}
+
+#endif
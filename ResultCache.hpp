@@ -0,0 +1,110 @@
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ------------------------------------------------------------------
+// LRU cache of search results as row ids, keyed by (store, query,
+// algorithm, data generation). Stores bump their generation whenever
+// row ids or row order change, so a stale entry can never be served;
+// dropStale() frees such entries eagerly.
+// ------------------------------------------------------------------
+class ResultCache {
+public:
+    struct Key {
+        const void* store;
+        std::string query;
+        int         algo;
+        uint64_t    generation;
+
+        bool operator==(const Key& o) const {
+            return store == o.store && algo == o.algo && generation == o.generation && query == o.query;
+        }
+    };
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            size_t h = std::hash<std::string>()(k.query);
+            h ^= std::hash<const void*>()(k.store) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+            h ^= std::hash<uint64_t>()(k.generation * 31 + uint64_t(k.algo)) + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    struct Entry {
+        Key                   key;
+        std::vector<uint32_t> rows;
+        size_t                bytes;
+    };
+
+    std::list<Entry>                                                lru;   // front = most recent
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> map;
+    size_t budget;
+    size_t used = 0;
+
+    static size_t footprint(const Key& k, const std::vector<uint32_t>& rows) {
+        return sizeof(Entry) + k.query.capacity() + rows.capacity() * sizeof(uint32_t);
+    }
+
+    void erase(std::list<Entry>::iterator it) {
+        used -= it->bytes;
+        map.erase(it->key);
+        lru.erase(it);
+    }
+
+public:
+    size_t hits = 0, misses = 0, evictions = 0;
+
+    explicit ResultCache(size_t budgetBytes) : budget(budgetBytes) {}
+
+    // Cached rows for k (and marks them most recent), or nullptr.
+    const std::vector<uint32_t>* find(const Key& k) {
+        auto it = map.find(k);
+        if (it == map.end()) { ++misses; return nullptr; }
+        ++hits;
+        lru.splice(lru.begin(), lru, it->second);
+        return &it->second->rows;
+    }
+
+    // Results larger than the whole budget are not cached.
+    void put(const Key& k, std::vector<uint32_t> rows) {
+        auto old = map.find(k);
+        if (old != map.end()) erase(old->second);
+        size_t bytes = footprint(k, rows);
+        if (bytes > budget) return;
+        while (used + bytes > budget && !lru.empty()) {
+            erase(std::prev(lru.end()));
+            ++evictions;
+        }
+        lru.push_front(Entry{ k, std::move(rows), bytes });
+        map.emplace(k, lru.begin());
+        used += bytes;
+    }
+
+    // Drops entries of store from any generation other than current.
+    void dropStale(const void* store, uint64_t current) {
+        for (auto it = lru.begin(); it != lru.end(); ) {
+            auto nx = std::next(it);
+            if (it->key.store == store && it->key.generation != current) erase(it);
+            it = nx;
+        }
+    }
+
+    void clear() {
+        lru.clear();
+        map.clear();
+        used = 0;
+    }
+
+    size_t entries()     const { return lru.size(); }
+    size_t memoryBytes() const { return used; }
+    size_t budgetBytes() const { return budget; }
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef RESULT_CURSOR_HPP
+#define RESULT_CURSOR_HPP
+
+#include "Transaction.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Forward cursor over search results. A lazy cursor pulls matching row
+// ids from its source only as pages are requested (plus a readahead);
+// rows themselves are never copied, only resolved through rowAt when
+// shown. A cursor over a known id list is complete from the start.
+// ------------------------------------------------------------------
+class ResultCursor {
+public:
+    typedef std::function<int64_t()>                           Source;   // next row id, -1 at end
+    typedef std::function<const Transaction&(uint32_t)>        RowAt;
+    typedef std::function<void(const std::vector<uint32_t>&)>  OnDone;
+
+private:
+    Source                src;
+    RowAt                 rowAt;
+    OnDone                onDone;
+    std::vector<uint32_t> ids;          // rows produced so far, in order
+    size_t                readahead = 0;
+    bool                  done      = true;
+
+    void finish() {
+        done = true;
+        src  = nullptr;
+        if (onDone) { onDone(ids); onDone = nullptr; }
+    }
+
+public:
+    ResultCursor() = default;
+
+    ResultCursor(Source s, RowAt r, size_t readaheadRows)
+      : src(std::move(s)), rowAt(std::move(r)), readahead(readaheadRows), done(false) {}
+
+    static ResultCursor overIds(std::vector<uint32_t> rows, RowAt r) {
+        ResultCursor c;
+        c.ids   = std::move(rows);
+        c.rowAt = std::move(r);
+        return c;
+    }
+
+    // Called once with every row id when a lazy cursor runs dry.
+    void onComplete(OnDone f) {
+        if (done) f(ids);
+        else      onDone = std::move(f);
+    }
+
+    // Makes rows [0, upto) available if they exist, pulling readahead
+    // rows beyond that; returns the number available.
+    size_t fetch(size_t upto) {
+        size_t want = upto + readahead;
+        while (!done && ids.size() < want) {
+            int64_t r = src();
+            if (r < 0) finish();
+            else       ids.push_back(uint32_t(r));
+        }
+        return ids.size();
+    }
+
+    // Runs the source to the end; returns the total.
+    size_t drain() {
+        while (!done) {
+            int64_t r = src();
+            if (r < 0) finish();
+            else       ids.push_back(uint32_t(r));
+        }
+        return ids.size();
+    }
+
+    bool   exhausted() const { return done; }
+    size_t available() const { return ids.size(); }
+    const Transaction& operator[](size_t i) const { return rowAt(ids[i]); }
+};
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef SCAN_KERNELS_HPP
+#define SCAN_KERNELS_HPP
+
+#include "Simd.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Vectorized equality scans over dictionary-coded columns.
+// Each kernel ORs its matches into a selection bitmap (bit r = row r),
+// so IN-lists are several calls on the same bitmap. AVX2 compares 32
+// one-byte or 16 two-byte codes per instruction.
+// ------------------------------------------------------------------
+namespace simd {
+
+inline void selectEq8Scalar(const uint8_t* c, size_t begin, size_t end, uint8_t code, uint64_t* sel) {
+    for (size_t r = begin; r < end; ++r)
+        sel[r >> 6] |= uint64_t(c[r] == code) << (r & 63);
+}
+
+inline void selectEq16Scalar(const uint16_t* c, size_t begin, size_t end, uint16_t code, uint64_t* sel) {
+    for (size_t r = begin; r < end; ++r)
+        sel[r >> 6] |= uint64_t(c[r] == code) << (r & 63);
+}
+
+#if SIMD_HAS_AVX2_TARGET
+SIMD_TARGET_AVX2
+inline void selectEq8AVX2(const uint8_t* c, size_t n, uint8_t code, uint64_t* sel) {
+    const __m256i key = _mm256_set1_epi8(char(code));
+    size_t r = 0;
+    for (; r + 64 <= n; r += 64) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + r));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + r + 32));
+        uint32_t lo = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, key)));
+        uint32_t hi = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, key)));
+        sel[r >> 6] |= uint64_t(lo) | (uint64_t(hi) << 32);
+    }
+    selectEq8Scalar(c, r, n, code, sel);
+}
+
+SIMD_TARGET_AVX2
+inline void selectEq16AVX2(const uint16_t* c, size_t n, uint16_t code, uint64_t* sel) {
+    const __m256i key = _mm256_set1_epi16(short(code));
+    size_t r = 0;
+    for (; r + 64 <= n; r += 64) {
+        uint64_t word = 0;
+        for (int part = 0; part < 2; ++part) {
+            const uint16_t* p = c + r + part * 32;
+            __m256i a  = _mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), key);
+            __m256i b  = _mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 16)), key);
+            // packs works per 128-bit lane; the permute restores row order
+            __m256i pk = _mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), 0xD8);
+            word |= uint64_t(uint32_t(_mm256_movemask_epi8(pk))) << (part * 32);
+        }
+        sel[r >> 6] |= word;
+    }
+    selectEq16Scalar(c, r, n, code, sel);
+}
+#endif
+
+inline void selectEq8(const uint8_t* c, size_t n, uint8_t code, uint64_t* sel) {
+#if SIMD_HAS_AVX2_TARGET
+    if (hasAVX2()) { selectEq8AVX2(c, n, code, sel); return; }
+#endif
+    selectEq8Scalar(c, 0, n, code, sel);
+}
+
+inline void selectEq16(const uint16_t* c, size_t n, uint16_t code, uint64_t* sel) {
+#if SIMD_HAS_AVX2_TARGET
+    if (hasAVX2()) { selectEq16AVX2(c, n, code, sel); return; }
+#endif
+    selectEq16Scalar(c, 0, n, code, sel);
+}
+
+} // namespace simd
+
+// ------------------------------------------------------------------
+// Column of dictionary codes, one per row. Starts at one byte per code
+// and widens to two bytes once the dictionary passes 256 values.
+// ------------------------------------------------------------------
+class CodeColumn {
+    std::vector<uint8_t>  c8;
+    std::vector<uint16_t> c16;
+    bool                  wide = false;
+
+public:
+    void clear() {
+        c8.clear();  c8.shrink_to_fit();
+        c16.clear(); c16.shrink_to_fit();
+        wide = false;
+    }
+
+    // Dictionaries are capped at 65536 values.
+    void push(uint32_t code) {
+        if (!wide && code > 0xFF) {
+            c16.assign(c8.begin(), c8.end());
+            c8.clear(); c8.shrink_to_fit();
+            wide = true;
+        }
+        if (wide) c16.push_back(uint16_t(code));
+        else      c8.push_back(uint8_t(code));
+    }
+
+    size_t   size()        const { return wide ? c16.size() : c8.size(); }
+    int      width()       const { return wide ? 2 : 1; }
+    uint32_t at(size_t r)  const { return wide ? c16[r] : c8[r]; }
+
+    // f(row, code) for every row, with the width test hoisted out of the loop.
+    template <class F>
+    void forEach(F f) const {
+        if (wide) for (size_t r = 0; r < c16.size(); ++r) f(r, uint32_t(c16[r]));
+        else      for (size_t r = 0; r < c8.size();  ++r) f(r, uint32_t(c8[r]));
+    }
+    size_t   memoryBytes() const { return c8.capacity() + c16.capacity() * sizeof(uint16_t); }
+
+    // sel must hold (size()+63)/64 words; matching rows are OR-ed in.
+    void select(uint32_t code, uint64_t* sel) const {
+        if (wide)             simd::selectEq16(c16.data(), c16.size(), uint16_t(code), sel);
+        else if (code < 256)  simd::selectEq8(c8.data(), c8.size(), uint8_t(code), sel);
+    }
+};
+
+// Bytes and time of one kernel pass, for throughput reporting.
+struct ScanStats {
+    size_t rows   = 0;
+    size_t bytes  = 0;
+    double micros = 0;
+
+    double gbPerSec() const { return micros > 0 ? bytes / (micros * 1e3) : 0; }
+};
+
+#endif
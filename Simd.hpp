@@ -0,0 +1,99 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+// ------------------------------------------------------------------
+// SIMD helpers. main.cpp is built with a plain `g++ main.cpp`, so AVX2
+// code paths are compiled per function through a target attribute and
+// picked at runtime; every kernel keeps a scalar fallback.
+// ------------------------------------------------------------------
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+  #include <immintrin.h>
+  #define SIMD_HAS_AVX2_TARGET 1
+  #define SIMD_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#else
+  #define SIMD_HAS_AVX2_TARGET 0
+  #define SIMD_TARGET_AVX2
+#endif
+
+namespace simd {
+
+inline bool hasAVX2() {
+#if SIMD_HAS_AVX2_TARGET
+    static const bool ok = __builtin_cpu_supports("avx2");
+    return ok;
+#else
+    return false;
+#endif
+}
+
+inline int popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    int c = 0;
+    while (x) { x &= x - 1; ++c; }
+    return c;
+#endif
+}
+
+inline int countTrailingZeros64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int c = 0;
+    while (!(x & 1)) { x >>= 1; ++c; }
+    return c;
+#endif
+}
+
+// ---- word-wise bitset kernels: out = a OP b, returns popcount(out) ----
+
+enum class WordOp { AND, OR, ANDNOT };
+
+inline uint64_t wordOpScalar(WordOp op, const uint64_t* a, const uint64_t* b,
+                             uint64_t* out, size_t words) {
+    uint64_t card = 0;
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t w = op == WordOp::AND ? (a[i] & b[i])
+                   : op == WordOp::OR  ? (a[i] | b[i])
+                   :                     (a[i] & ~b[i]);
+        out[i] = w;
+        card += popcount64(w);
+    }
+    return card;
+}
+
+#if SIMD_HAS_AVX2_TARGET
+SIMD_TARGET_AVX2
+inline uint64_t wordOpAVX2(WordOp op, const uint64_t* a, const uint64_t* b,
+                           uint64_t* out, size_t words) {
+    uint64_t card = 0;
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i r  = op == WordOp::AND ? _mm256_and_si256(va, vb)
+                   : op == WordOp::OR  ? _mm256_or_si256(va, vb)
+                   :                     _mm256_andnot_si256(vb, va);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), r);
+        card += __builtin_popcountll(out[i])   + __builtin_popcountll(out[i+1])
+              + __builtin_popcountll(out[i+2]) + __builtin_popcountll(out[i+3]);
+    }
+    return card + wordOpScalar(op, a + i, b + i, out + i, words - i);
+}
+#endif
+
+inline uint64_t wordOp(WordOp op, const uint64_t* a, const uint64_t* b,
+                       uint64_t* out, size_t words) {
+#if SIMD_HAS_AVX2_TARGET
+    if (hasAVX2()) return wordOpAVX2(op, a, b, out, words);
+#endif
+    return wordOpScalar(op, a, b, out, words);
+}
+
+} // namespace simd
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef SORT_KEYS_HPP
+#define SORT_KEYS_HPP
+
+#include "AdaptiveSort.hpp"
+#include "ParallelSort.hpp"
+#include "Transaction.hpp"
+#include "TransactionFields.hpp"
+
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Multi-column sort keys. A key list read at runtime ("location, amount
+// desc, timestamp") is turned once per sort into a KeyTuple type whose
+// elements compare two row ids on one column each: text and bool columns
+// through a member pointer, numeric ones (decimal text included) through
+// doubles gathered per row once per sort. The comparator a sort
+// instantiates is a chain of inlined compares: no field switch and no
+// virtual call per comparison.
+// ------------------------------------------------------------------
+struct SortKey {
+    Field field;
+    bool  desc = false;
+};
+
+const size_t MAX_SORT_KEYS = 3;
+const size_t ADAPTIVE_RUN  = 32;   // "mostly ordered": <= 1 step against the order per 32 rows
+
+inline int compare3(const std::string& x, const std::string& y) {
+    int c = x.compare(y);
+    return (c > 0) - (c < 0);
+}
+inline int compare3(double x, double y) { return (x > y) - (x < y); }
+inline int compare3(bool x, bool y)     { return int(x) - int(y); }
+
+// Sort value of a numeric column's text. Blank reads as 0 on the double
+// columns (as the loaders store it) and as lowest on the decimal text ones.
+inline double sortNumber(Field f, std::string_view text) {
+    if (text.empty()) return isNumeric(f) ? 0.0 : -std::numeric_limits<double>::infinity();
+    return std::strtod(std::string(text).c_str(), nullptr);
+}
+inline double sortNumber(const Transaction& t, Field f) {
+    return isNumeric(f) ? numericField(t, f) : sortNumber(f, *stringField(t, f));
+}
+
+template <class M>
+struct ColumnKey {
+    const Transaction* const* rows;     // row id -> row
+    M Transaction::*          member;
+    int                       sign;     // 1 ascending, -1 descending
+
+    int compare(uint32_t x, uint32_t y) const {
+        return sign * compare3(rows[x]->*member, rows[y]->*member);
+    }
+};
+
+template <>
+struct ColumnKey<double> {
+    const double* values;               // row id -> sortNumber
+    int           sign;
+
+    int compare(uint32_t x, uint32_t y) const { return sign * compare3(values[x], values[y]); }
+};
+
+template <class... Keys>
+struct KeyTuple {
+    std::tuple<Keys...> keys;
+
+    // <0, 0 or >0; later keys only break ties of earlier ones
+    int compare(uint32_t x, uint32_t y) const { return from<0>(x, y); }
+
+private:
+    template <size_t I>
+    int from(uint32_t x, uint32_t y) const {
+        if constexpr (I == sizeof...(Keys)) return 0;
+        else {
+            int c = std::get<I>(keys).compare(x, y);
+            return c ? c : from<I + 1>(x, y);
+        }
+    }
+};
+
+inline std::string Transaction::* stringMember(Field f) {
+    switch (f) {
+    case Field::transaction_id:              return &Transaction::transaction_id;
+    case Field::timestamp:                   return &Transaction::timestamp;
+    case Field::sender_account:              return &Transaction::sender_account;
+    case Field::receiver_account:            return &Transaction::receiver_account;
+    case Field::transaction_type:            return &Transaction::transaction_type;
+    case Field::merchant_category:           return &Transaction::merchant_category;
+    case Field::location:                    return &Transaction::location;
+    case Field::device_used:                 return &Transaction::device_used;
+    case Field::fraud_type:                  return &Transaction::fraud_type;
+    case Field::time_since_last_transaction: return &Transaction::time_since_last_transaction;
+    case Field::spending_deviation_score:    return &Transaction::spending_deviation_score;
+    case Field::payment_channel:             return &Transaction::payment_channel;
+    case Field::ip_address:                  return &Transaction::ip_address;
+    case Field::device_hash:                 return &Transaction::device_hash;
+    default:                                 return nullptr;
+    }
+}
+
+// Sort values of the numeric keys of spec, one vector per key (empty for
+// text and bool keys), indexed by row id.
+struct KeyValues {
+    std::vector<double> values[MAX_SORT_KEYS];
+
+    KeyValues(const std::vector<SortKey>& spec, const Transaction* const* rows, size_t n) {
+        for (size_t i = 0; i < spec.size() && i < MAX_SORT_KEYS; ++i) {
+            if (!ordersAsNumber(spec[i].field)) continue;
+            values[i].resize(n);
+            for (size_t r = 0; r < n; ++r) values[i][r] = sortNumber(*rows[r], spec[i].field);
+        }
+    }
+};
+
+namespace detail {
+template <class F, class... Built>
+void withKeys(const std::vector<SortKey>& spec, size_t i, const Transaction* const* rows,
+              const KeyValues& kv, F& f, std::tuple<Built...> built) {
+    if constexpr (sizeof...(Built) < MAX_SORT_KEYS) {
+        if (i < spec.size()) {
+            Field fl   = spec[i].field;
+            int   sign = spec[i].desc ? -1 : 1;
+            if (fl == Field::is_fraud)
+                withKeys(spec, i + 1, rows, kv, f, std::tuple_cat(built,
+                         std::make_tuple(ColumnKey<bool>{ rows, &Transaction::is_fraud, sign })));
+            else if (ordersAsNumber(fl))
+                withKeys(spec, i + 1, rows, kv, f, std::tuple_cat(built,
+                         std::make_tuple(ColumnKey<double>{ kv.values[i].data(), sign })));
+            else
+                withKeys(spec, i + 1, rows, kv, f, std::tuple_cat(built,
+                         std::make_tuple(ColumnKey<std::string>{ rows, stringMember(fl), sign })));
+            return;
+        }
+    }
+    f(KeyTuple<Built...>{ built });
+}
+} // namespace detail
+
+// Calls f(KeyTuple<...>) with the tuple type matching spec's column types;
+// the tuple compares row ids of rows, kv must hold spec's numeric values.
+template <class F>
+void withKeyTuple(const std::vector<SortKey>& spec, const Transaction* const* rows,
+                  const KeyValues& kv, F f) {
+    detail::withKeys(spec, 0, rows, kv, f, std::tuple<>());
+}
+
+// Stable sort of ids[0, n) by keys, where rows[id] is the row of each id.
+// Shared by both stores so each key-type tuple is instantiated once.
+// One pass first counts steps up and down the key order; input that is
+// already mostly ascending or descending (an extract kept in timestamp
+// order, say) goes to the adaptive run-merging sort, anything else to the
+// parallel merge sort. Returns true when the adaptive sort ran.
+inline bool sortRowsByKeys(uint32_t* ids, size_t n, const Transaction* const* rows,
+                           const std::vector<SortKey>& keys, ThreadPool& pool) {
+    KeyValues kv(keys, rows, n);
+    bool adaptive = false;
+    withKeyTuple(keys, rows, kv, [&](auto kt) {
+        auto less = [&](uint32_t x, uint32_t y){ return kt.compare(x, y) < 0; };
+        size_t limit = n / ADAPTIVE_RUN, up = 0, down = 0;
+        for (size_t i = 1; i < n && (up <= limit || down <= limit); ++i) {
+            int c = kt.compare(ids[i-1], ids[i]);
+            up   += c < 0;
+            down += c > 0;
+        }
+        adaptive = up <= limit || down <= limit;
+        if (adaptive) {
+            adsort::adaptiveSort(ids, n, less);
+        } else {
+            std::vector<uint32_t> scratch(n);
+            psort::parallelMergeSort(ids, scratch.data(), n, less, pool);
+        }
+    });
+    return adaptive;
+}
+
+// "location, amount desc, timestamp" -> keys. Each term is a column name
+// or alias, optionally followed by asc/desc. False (with err) on a bad term.
+inline bool parseSortKeys(const std::string& text, std::vector<SortKey>& out, std::string& err) {
+    out.clear();
+    std::stringstream terms(text);
+    std::string term;
+    while (std::getline(terms, term, ',')) {
+        std::istringstream ts(term);
+        std::string name, dir, extra;
+        if (!(ts >> name)) continue;
+        ts >> dir >> extra;
+        for (auto& ch : dir) ch = char(std::tolower((unsigned char)ch));
+        SortKey k;
+        if (!fieldFromName(name, k.field)) { err = "unknown column '" + name + "'"; return false; }
+        if (dir == "desc")                  k.desc = true;
+        else if (!dir.empty() && dir != "asc") { err = "expected asc/desc after " + name; return false; }
+        if (!extra.empty())                 { err = "unexpected '" + extra + "'"; return false; }
+        out.push_back(k);
+    }
+    if (out.empty())                { err = "no sort columns given"; return false; }
+    if (out.size() > MAX_SORT_KEYS) {
+        err = "at most " + std::to_string(MAX_SORT_KEYS) + " sort columns";
+        return false;
+    }
+    return true;
+}
+
+inline std::string sortKeysLabel(const std::vector<SortKey>& keys) {
+    std::string s;
+    for (const auto& k : keys) {
+        if (!s.empty()) s += ", ";
+        s += fieldName(k.field);
+        if (k.desc) s += " desc";
+    }
+    return s;
+}
+
+#endif
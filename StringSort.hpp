@@ -0,0 +1,144 @@
+#ifndef STRING_SORT_HPP
+#define STRING_SORT_HPP
+
+#include "BitmapIndex.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Stable MSD radix sort of a row-id permutation by a string column.
+// Each pass reads the byte at the current depth of every key once into
+// a byte cache (the "oracle"), counts it, then scatters the ids by that
+// cached byte; there are no string comparisons in a pass. Keys that end
+// at the current depth form bucket 0 and are done. Buckets smaller than
+// RADIX_CUTOFF are finished by insertion sort on the key suffixes.
+// Keys must not contain NUL bytes.
+// ------------------------------------------------------------------
+namespace strsort {
+
+const size_t RADIX_CUTOFF = 32;
+
+template <class T, class KeyAt>
+class MsdRadix {
+    KeyAt                keyAt;    // row id -> const std::string&
+    std::vector<T>       tmp;
+    std::vector<uint8_t> oracle;
+
+    static uint8_t byteAt(const std::string& s, size_t d) {
+        return d < s.size() ? uint8_t(s[d]) : 0;
+    }
+
+    // keys in a[0, n) share their first `depth` bytes
+    void insertion(T* a, size_t n, size_t depth) {
+        for (size_t i = 1; i < n; ++i) {
+            T v = a[i];
+            const std::string& s = keyAt(v);
+            size_t j = i;
+            for (; j > 0 && s.compare(depth, std::string::npos,
+                                      keyAt(a[j-1]), depth, std::string::npos) < 0; --j)
+                a[j] = a[j-1];
+            a[j] = v;
+        }
+    }
+
+    void sort(T* a, uint8_t* orc, T* buf, size_t n, size_t depth) {
+        while (n >= RADIX_CUTOFF) {
+            size_t count[256] = { 0 };
+            for (size_t i = 0; i < n; ++i) ++count[orc[i] = byteAt(keyAt(a[i]), depth)];
+
+            // one non-empty bucket: nothing moves, go one byte deeper
+            if (count[orc[0]] == n) {
+                if (orc[0] == 0) return;
+                ++depth;
+                continue;
+            }
+
+            size_t start[256], pos = 0;
+            for (int c = 0; c < 256; ++c) { start[c] = pos; pos += count[c]; }
+            size_t next[256];
+            std::copy(start, start + 256, next);
+            for (size_t i = 0; i < n; ++i) buf[next[orc[i]]++] = a[i];
+            std::copy(buf, buf + n, a);
+
+            for (int c = 1; c < 256; ++c)
+                if (count[c] > 1) sort(a + start[c], orc + start[c], buf + start[c], count[c], depth + 1);
+            return;
+        }
+        insertion(a, n, depth);
+    }
+
+public:
+    explicit MsdRadix(KeyAt k) : keyAt(k) {}
+
+    void operator()(T* a, size_t n) {
+        tmp.resize(n);
+        oracle.resize(n);
+        sort(a, oracle.data(), tmp.data(), n, 0);
+    }
+};
+
+template <class T, class KeyAt>
+void msdRadixSort(T* a, size_t n, KeyAt keyAt) {
+    MsdRadix<T, KeyAt> r(keyAt);
+    r(a, n);
+}
+
+// ------------------------------------------------------------------
+// Normalized sort key: the first 8 bytes of the string as a big-endian
+// integer (zero padded), so integer order is byte order, plus the row
+// id. Comparisons settle on the integer unless both keys run past 8
+// bytes with the same prefix; only then are the string tails compared.
+// Keys must not contain NUL bytes.
+// ------------------------------------------------------------------
+struct PrefixKey {
+    uint64_t prefix;
+    uint32_t row;
+    uint32_t more;    // string is longer than the prefix
+};
+
+inline PrefixKey prefixKey(const std::string& s, uint32_t row) {
+    unsigned char b[8] = { 0 };
+    std::memcpy(b, s.data(), std::min<size_t>(8, s.size()));
+    uint64_t p = 0;
+    for (int i = 0; i < 8; ++i) p = (p << 8) | b[i];
+    return { p, row, uint32_t(s.size() > 8) };
+}
+
+template <class KeyAt>
+int comparePrefixed(const PrefixKey& x, const PrefixKey& y, KeyAt keyAt) {
+    if (x.prefix != y.prefix) return x.prefix < y.prefix ? -1 : 1;
+    if (!x.more || !y.more)   return int(x.more) - int(y.more);   // shorter one first
+    int c = keyAt(x.row).compare(8, std::string::npos, keyAt(y.row), 8, std::string::npos);
+    return (c > 0) - (c < 0);
+}
+
+// ------------------------------------------------------------------
+// Counting sort of rows [0, n) by a dictionary-coded column: one pass
+// counts rows per code, the counts are laid out in value order of the
+// codes, and a second pass drops each row id into its code's next slot.
+// Rows are visited in id order, so equal values keep load order.
+// n must be the column's row count, so out[0, n) is a full permutation.
+// ------------------------------------------------------------------
+template <class T>
+void countingSortByCode(T* out, const BitmapIndex::Column& c, size_t n) {
+    assert(n == c.codes.size());
+    std::vector<size_t> next(c.values.size(), 0);
+    c.codes.forEach([&](size_t, uint32_t code){ ++next[code]; });
+    size_t pos = 0;
+    for (uint32_t code : c.codesByValue()) {
+        size_t count = next[code];
+        next[code] = pos;
+        pos += count;
+    }
+    c.codes.forEach([&](size_t r, uint32_t code){ out[next[code]++] = T(r); });
+}
+
+} // namespace strsort
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Fixed-size worker pool with a shared FIFO queue. parallelFor splits
+// [0, n) into contiguous chunks and blocks until all of them are done.
+// Called from one of the pool's own workers (a nested parallelFor), it
+// runs the chunks inline: queueing them could leave every worker
+// blocked waiting on jobs that no free worker is left to run.
+// ------------------------------------------------------------------
+class ThreadPool {
+    std::vector<std::thread>          workers;
+    std::deque<std::function<void()>> queue;
+    std::mutex                        mtx;
+    std::condition_variable           cv;
+    bool                              stopping = false;
+
+    // the pool whose worker is running on this thread, if any
+    static const ThreadPool*& workerOf() {
+        static thread_local const ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    void workerLoop() {
+        workerOf() = this;
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lk(mtx);
+                cv.wait(lk, [this]{ return stopping || !queue.empty(); });
+                if (stopping && queue.empty()) return;
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            job();
+        }
+    }
+
+public:
+    // 0 = one worker per hardware thread.
+    explicit ThreadPool(unsigned threads = 0) {
+        if (!threads) threads = hardwareThreads();
+        for (unsigned i = 0; i < threads; ++i)
+            workers.emplace_back([this]{ workerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static unsigned hardwareThreads() {
+        unsigned hc = std::thread::hardware_concurrency();
+        return hc ? hc : 1;
+    }
+
+    unsigned size() const { return unsigned(workers.size()); }
+
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            queue.push_back(std::move(job));
+        }
+        cv.notify_one();
+    }
+
+    // body(chunk, begin, end) for `chunks` contiguous slices of [0, n).
+    template <class F>
+    void parallelFor(size_t n, size_t chunks, F body) {
+        chunks = std::max<size_t>(1, std::min(chunks, n));
+        if (chunks == 1 || size() == 1 || workerOf() == this) {
+            for (size_t c = 0; c < chunks; ++c) body(c, n * c / chunks, n * (c + 1) / chunks);
+            return;
+        }
+        std::mutex              doneMtx;
+        std::condition_variable doneCv;
+        size_t                  remaining = chunks;
+        for (size_t c = 0; c < chunks; ++c) {
+            submit([&, c]{
+                body(c, n * c / chunks, n * (c + 1) / chunks);
+                std::lock_guard<std::mutex> lk(doneMtx);
+                if (--remaining == 0) doneCv.notify_one();
+            });
+        }
+        std::unique_lock<std::mutex> lk(doneMtx);
+        doneCv.wait(lk, [&]{ return remaining == 0; });
+    }
+};
+
+// Process-wide pool, resized on demand (0 = all hardware threads).
+inline ThreadPool& sharedPool(unsigned threads = 0) {
+    static std::unique_ptr<ThreadPool> pool;
+    if (!threads) threads = ThreadPool::hardwareThreads();
+    if (!pool || pool->size() != threads) {
+        pool.reset();
+        pool.reset(new ThreadPool(threads));
+    }
+    return *pool;
+}
+
+// One-worker pool for serial baselines: parallelFor runs inline on it,
+// and unlike sharedPool(1) it leaves the shared pool's size alone.
+inline ThreadPool& serialPool() {
+    static ThreadPool pool(1);
+    return pool;
+}
+
+// ------------------------------------------------------------------
+// Fork-join pool for recursive tasks. Each worker owns a deque: it
+// pushes and pops spawned tasks at the back (newest, still hot in
+// cache) while idle workers steal from the front of the others (oldest,
+// hence largest, subproblems). run() makes the calling thread worker 0
+// and returns once the root and everything it spawned has finished.
+// run() does not nest.
+// ------------------------------------------------------------------
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Task;
+
+private:
+    struct Slot {
+        std::mutex       mtx;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Slot>> slots;     // slot 0 = thread inside run()
+    std::vector<std::thread>           workers;
+    std::atomic<size_t>                pending{0};
+    std::mutex                         mtx;
+    std::condition_variable            cv;
+    uint64_t                           epoch    = 0;
+    bool                               stopping = false;
+
+    static int& currentSlot() {
+        static thread_local int slot = -1;
+        return slot;
+    }
+
+    bool popLocal(int s, Task& t) {
+        Slot& sl = *slots[s];
+        std::lock_guard<std::mutex> lk(sl.mtx);
+        if (sl.tasks.empty()) return false;
+        t = std::move(sl.tasks.back());
+        sl.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int s, Task& t) {
+        for (size_t k = 1; k < slots.size(); ++k) {
+            Slot& sl = *slots[(s + k) % slots.size()];
+            std::lock_guard<std::mutex> lk(sl.mtx);
+            if (sl.tasks.empty()) continue;
+            t = std::move(sl.tasks.front());
+            sl.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void workUntilDone(int s) {
+        while (pending.load(std::memory_order_acquire) != 0) {
+            Task t;
+            if (popLocal(s, t) || steal(s, t)) {
+                t();
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void workerLoop(int s) {
+        currentSlot() = s;
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lk(mtx);
+                cv.wait(lk, [&]{ return stopping || epoch != seen; });
+                if (stopping) return;
+                seen = epoch;
+            }
+            workUntilDone(s);
+        }
+    }
+
+public:
+    // 0 = one worker per hardware thread, the caller of run() included.
+    explicit WorkStealingPool(unsigned threads = 0) {
+        if (!threads) threads = ThreadPool::hardwareThreads();
+        for (unsigned i = 0; i < threads; ++i) slots.emplace_back(new Slot());
+        for (unsigned i = 1; i < threads; ++i)
+            workers.emplace_back([this, i]{ workerLoop(int(i)); });
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&)            = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return unsigned(slots.size()); }
+
+    // Queues t on the calling worker's deque; only valid inside run().
+    void spawn(Task t) {
+        int s = currentSlot();
+        pending.fetch_add(1, std::memory_order_acq_rel);
+        Slot& sl = *slots[s < 0 ? 0 : s];
+        std::lock_guard<std::mutex> lk(sl.mtx);
+        sl.tasks.push_back(std::move(t));
+    }
+
+    void run(Task root) {
+        int outer = currentSlot();
+        currentSlot() = 0;
+        spawn(std::move(root));
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            ++epoch;
+        }
+        cv.notify_all();
+        workUntilDone(0);
+        currentSlot() = outer;
+    }
+};
+
+// Process-wide fork-join pool, resized on demand (0 = all hardware threads).
+inline WorkStealingPool& sharedStealingPool(unsigned threads = 0) {
+    static std::unique_ptr<WorkStealingPool> pool;
+    if (!threads) threads = ThreadPool::hardwareThreads();
+    if (!pool || pool->size() != threads) {
+        pool.reset();
+        pool.reset(new WorkStealingPool(threads));
+    }
+    return *pool;
+}
+
+#endif
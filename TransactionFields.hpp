@@ -0,0 +1,137 @@
+#ifndef TRANSACTION_FIELDS_HPP
+#define TRANSACTION_FIELDS_HPP
+
+#include "Transaction.hpp"
+
+#include <string>
+
+// ------------------------------------------------------------------
+// Field registry: names and accessors for every Transaction column,
+// so indexes and queries can address a column at runtime.
+// ------------------------------------------------------------------
+enum class Field : int {
+    transaction_id,
+    timestamp,
+    sender_account,
+    receiver_account,
+    amount,
+    transaction_type,
+    merchant_category,
+    location,
+    device_used,
+    is_fraud,
+    fraud_type,
+    time_since_last_transaction,
+    spending_deviation_score,
+    velocity_score,
+    geo_anomaly_score,
+    payment_channel,
+    ip_address,
+    device_hash,
+    COUNT
+};
+
+static const int FIELD_COUNT = static_cast<int>(Field::COUNT);
+
+inline const char* fieldName(Field f) {
+    static const char* names[FIELD_COUNT] = {
+        "transaction_id", "timestamp", "sender_account", "receiver_account",
+        "amount", "transaction_type", "merchant_category", "location",
+        "device_used", "is_fraud", "fraud_type", "time_since_last_transaction",
+        "spending_deviation_score", "velocity_score", "geo_anomaly_score",
+        "payment_channel", "ip_address", "device_hash"
+    };
+    return names[static_cast<int>(f)];
+}
+
+// Accepts the column name, with a few short aliases ("type", "channel", ...).
+// Returns false if the name is unknown.
+inline bool fieldFromName(const std::string& name, Field& out) {
+    for (int i = 0; i < FIELD_COUNT; ++i) {
+        if (name == fieldName(static_cast<Field>(i))) {
+            out = static_cast<Field>(i);
+            return true;
+        }
+    }
+    struct Alias { const char* name; Field f; };
+    static const Alias aliases[] = {
+        {"id", Field::transaction_id},       {"type", Field::transaction_type},
+        {"channel", Field::payment_channel}, {"merchant", Field::merchant_category},
+        {"device", Field::device_used},      {"fraud", Field::is_fraud},
+        {"sender", Field::sender_account},   {"receiver", Field::receiver_account},
+        {"velocity", Field::velocity_score}, {"geo", Field::geo_anomaly_score},
+        {"time", Field::timestamp}
+    };
+    for (const auto& a : aliases) {
+        if (name == a.name) { out = a.f; return true; }
+    }
+    return false;
+}
+
+// Columns holding a small set of repeated values (bitmap-indexable).
+inline bool isCategorical(Field f) {
+    switch (f) {
+    case Field::transaction_type:
+    case Field::merchant_category:
+    case Field::location:
+    case Field::device_used:
+    case Field::is_fraud:
+    case Field::fraud_type:
+    case Field::payment_channel:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Columns stored as double in Transaction.
+inline bool isNumeric(Field f) {
+    return f == Field::amount || f == Field::velocity_score || f == Field::geo_anomaly_score;
+}
+
+// Columns that order as numbers: the double columns plus the two signed
+// decimal columns kept as text.
+inline bool isNumericText(Field f) {
+    return f == Field::time_since_last_transaction || f == Field::spending_deviation_score;
+}
+inline bool ordersAsNumber(Field f) { return isNumeric(f) || isNumericText(f); }
+
+// Pointer to a string column, or nullptr for numeric/bool columns.
+inline const std::string* stringField(const Transaction& t, Field f) {
+    switch (f) {
+    case Field::transaction_id:              return &t.transaction_id;
+    case Field::timestamp:                   return &t.timestamp;
+    case Field::sender_account:              return &t.sender_account;
+    case Field::receiver_account:            return &t.receiver_account;
+    case Field::transaction_type:            return &t.transaction_type;
+    case Field::merchant_category:           return &t.merchant_category;
+    case Field::location:                    return &t.location;
+    case Field::device_used:                 return &t.device_used;
+    case Field::fraud_type:                  return &t.fraud_type;
+    case Field::time_since_last_transaction: return &t.time_since_last_transaction;
+    case Field::spending_deviation_score:    return &t.spending_deviation_score;
+    case Field::payment_channel:             return &t.payment_channel;
+    case Field::ip_address:                  return &t.ip_address;
+    case Field::device_hash:                 return &t.device_hash;
+    default:                                 return nullptr;
+    }
+}
+
+inline double numericField(const Transaction& t, Field f) {
+    switch (f) {
+    case Field::amount:            return t.amount;
+    case Field::velocity_score:    return t.velocity_score;
+    case Field::geo_anomaly_score: return t.geo_anomaly_score;
+    case Field::is_fraud:          return t.is_fraud ? 1.0 : 0.0;
+    default:                       return 0.0;
+    }
+}
+
+// Value of any column as text; is_fraud renders as "true"/"false".
+inline std::string fieldText(const Transaction& t, Field f) {
+    if (const std::string* s = stringField(t, f)) return *s;
+    if (f == Field::is_fraud) return t.is_fraud ? "true" : "false";
+    return std::to_string(numericField(t, f));
+}
+
+#endif
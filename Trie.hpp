@@ -0,0 +1,157 @@
+#ifndef TRIE_HPP
+#define TRIE_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Trie over the distinct values of one column (a dictionary), keyed on
+// the lower-cased value. Lookups return dictionary codes, which the
+// caller resolves to rows through the bitmap index.
+// ------------------------------------------------------------------
+class DictionaryTrie {
+    struct Node {
+        std::vector<std::pair<char, int>> next;   // sorted by char
+        std::vector<int>                  codes;  // values ending here
+    };
+
+    std::vector<Node>        nodes;
+    std::vector<std::string> values;   // original spelling, by code
+
+    static std::string fold(const std::string& s) {
+        std::string r(s);
+        std::transform(r.begin(), r.end(), r.begin(),
+                       [](unsigned char c){ return char(std::tolower(c)); });
+        return r;
+    }
+
+    int child(int node, char c) const {
+        const auto& nx = nodes[node].next;
+        auto it = std::lower_bound(nx.begin(), nx.end(), std::make_pair(c, -1));
+        return (it != nx.end() && it->first == c) ? it->second : -1;
+    }
+
+    int walk(const std::string& key) const {
+        int cur = 0;
+        for (char c : key) {
+            cur = child(cur, c);
+            if (cur < 0) return -1;
+        }
+        return cur;
+    }
+
+    void collect(int node, std::vector<int>& out) const {
+        const Node& nd = nodes[node];
+        out.insert(out.end(), nd.codes.begin(), nd.codes.end());
+        for (const auto& e : nd.next) collect(e.second, out);
+    }
+
+    // Levenshtein DP carried down the trie; prev is the row of the parent.
+    void fuzzy(int node, char c, const std::string& q, const std::vector<int>& prev,
+               int maxEdits, std::vector<std::pair<int, int>>& out) const {
+        std::vector<int> row(q.size() + 1);
+        row[0] = prev[0] + 1;
+        int best = row[0];
+        for (size_t j = 1; j <= q.size(); ++j) {
+            int sub = prev[j-1] + (q[j-1] == c ? 0 : 1);
+            row[j] = std::min({ row[j-1] + 1, prev[j] + 1, sub });
+            best   = std::min(best, row[j]);
+        }
+        if (row[q.size()] <= maxEdits)
+            for (int code : nodes[node].codes) out.push_back({ row[q.size()], code });
+        if (best > maxEdits) return;   // no extension can get back under the bound
+        for (const auto& e : nodes[node].next)
+            fuzzy(e.second, e.first, q, row, maxEdits, out);
+    }
+
+public:
+    enum Mode { NOCASE, PREFIX, FUZZY };
+
+    DictionaryTrie() { clear(); }
+
+    void clear() {
+        nodes.assign(1, Node());
+        values.clear();
+    }
+
+    // codes are positions in vals
+    void build(const std::vector<std::string>& vals) {
+        clear();
+        values = vals;
+        for (int code = 0; code < int(vals.size()); ++code) {
+            int cur = 0;
+            for (char c : fold(vals[code])) {
+                int nx = child(cur, c);
+                if (nx < 0) {
+                    nx = int(nodes.size());
+                    nodes.emplace_back();
+                    auto& v = nodes[cur].next;
+                    v.insert(std::lower_bound(v.begin(), v.end(), std::make_pair(c, -1)),
+                             std::make_pair(c, nx));
+                }
+                cur = nx;
+            }
+            nodes[cur].codes.push_back(code);
+        }
+    }
+
+    size_t size() const { return values.size(); }
+    const std::string& value(int code) const { return values[code]; }
+
+    // Case-insensitive exact match.
+    std::vector<int> exact(const std::string& q) const {
+        int node = walk(fold(q));
+        return node < 0 ? std::vector<int>() : nodes[node].codes;
+    }
+
+    // All values starting with q, case-insensitive.
+    std::vector<int> prefix(const std::string& q) const {
+        std::vector<int> out;
+        int node = walk(fold(q));
+        if (node >= 0) collect(node, out);
+        return out;
+    }
+
+    // Values within maxEdits (insert/delete/substitute) of q, case-insensitive,
+    // closest first.
+    std::vector<int> withinDistance(const std::string& q, int maxEdits) const {
+        std::string fq = fold(q);
+        std::vector<int> row0(fq.size() + 1);
+        for (size_t j = 0; j <= fq.size(); ++j) row0[j] = int(j);
+
+        std::vector<std::pair<int, int>> hits;
+        if (row0[fq.size()] <= maxEdits)
+            for (int code : nodes[0].codes) hits.push_back({ row0[fq.size()], code });
+        for (const auto& e : nodes[0].next)
+            fuzzy(e.second, e.first, fq, row0, maxEdits, hits);
+
+        std::sort(hits.begin(), hits.end());
+        std::vector<int> out;
+        for (const auto& h : hits) out.push_back(h.second);
+        return out;
+    }
+
+    // Dictionary values matching q under the given mode.
+    std::vector<std::string> expand(const std::string& q, Mode m, int maxEdits = 0) const {
+        std::vector<int> codes = m == NOCASE ? exact(q)
+                               : m == PREFIX ? prefix(q)
+                               :               withinDistance(q, maxEdits);
+        std::vector<std::string> out;
+        out.reserve(codes.size());
+        for (int c : codes) out.push_back(values[c]);
+        return out;
+    }
+
+    size_t memoryBytes() const {
+        size_t b = sizeof(DictionaryTrie) + nodes.capacity() * sizeof(Node);
+        for (const auto& n : nodes)
+            b += n.next.capacity() * sizeof(std::pair<char, int>) + n.codes.capacity() * sizeof(int);
+        for (const auto& v : values) b += sizeof(std::string) + v.capacity();
+        return b;
+    }
+};
+
+#endif
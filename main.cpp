@@ -1,4 +1,22 @@
 #include "Transaction.hpp"
+#include "TransactionFields.hpp"
+#include "BitmapIndex.hpp"
+#include "HashIndex.hpp"
+#include "AccountIndex.hpp"
+#include "NumericIndex.hpp"
+#include "Query.hpp"
+#include "Trie.hpp"
+#include "ThreadPool.hpp"
+#include "ParallelSort.hpp"
+#include "StringSort.hpp"
+#include "AdaptiveSort.hpp"
+#include "SortKeys.hpp"
+#include "ExternalSort.hpp"
+#include "ResultCache.hpp"
+#include "Eytzinger.hpp"
+#include "BloomFilter.hpp"
+#include "Aggregate.hpp"
+#include "ResultCursor.hpp"
 #include "nlohmann_json.hpp"
 
 #include <iostream>
@@ -12,6 +30,8 @@
 #include <filesystem>
 #include <iomanip>
 #include <mutex>
+#include <random>
+#include <unordered_set>
 
 #if defined(_WIN32)
   #include <windows.h>
@@ -158,16 +178,75 @@ struct TransactionList {
 static TransactionList lastResults;
 static string          lastLabel;
 static bool            hasResults = false;
+static ResultCache     queryCache(64u << 20);   // Type=/Location= results as row ids
+static ResultCursor    lastCursor;              // pages of the last search
+static bool            lastMaterialized = true; // lastResults holds every row of lastCursor
+static const size_t    READAHEAD_ROWS = 4 * PAGE_SIZE;
+
+// Points lastCursor at the rows held in lastResults.
+static void cursorOverLastResults() {
+    vector<uint32_t> ids(size_t(lastResults.count));
+    iota(ids.begin(), ids.end(), 0u);
+    lastCursor = ResultCursor::overIds(std::move(ids),
+        [](uint32_t i) -> const Transaction& { return lastResults.data[i]; });
+    lastMaterialized = true;
+}
+
+// Copies a lazy lastCursor into lastResults. Needed for export and
+// before the store it reads from is sorted or reloaded.
+static void settleLastResults() {
+    if (lastMaterialized) return;
+    size_t total = lastCursor.drain();
+    TransactionList out(max<int>(1, int(total)));
+    for (size_t i = 0; i < total; ++i) out.push(lastCursor[i]);
+    lastResults = std::move(out);
+    cursorOverLastResults();
+}
 
 // ------------------------------------------------------------------
 // ArrayStore: 1D array + quicksort + mergesort + binary searches
 // ------------------------------------------------------------------
 class ArrayStore {
     Transaction* A;
-    int* idx;
+    int* idxBuf;                     // load-order permutation
+    int* idx;                        // current order: idxBuf or a cached sorted permutation
+    bool desc = false;               // read idx back to front
     int n;
     TransactionList channels[4];
     string lastChannel;
+    BitmapIndex bix;
+    mutable NumericIndexes numIdx;   // built on first range query
+    DictionaryTrie locTrie;          // distinct locations, rebuilt per load
+    HashIndex idIndex;               // transaction_id -> row, built at load
+    mutable AccountIndex acctIdx;    // sender/receiver CSR, built on first use
+    mutable EytzingerIndex sortedCat[FIELD_COUNT];   // binary-search indexes, built on first use
+    FieldFilters filters;            // Bloom filters for point-lookup columns, built after a load
+    uint64_t gen = 0;                // bumped whenever rows or idx order change
+    uint64_t loadGen = 0;            // bumped on load/reset only
+    uint64_t cachedSorts = 0;        // sorts answered from sortedBy[] without sorting
+
+    // ascending permutation per column, valid while loadGen matches. Every
+    // algorithm yields the same one (ties in load order), so any sort of f
+    // may serve another; descending sorts read it reversed.
+    struct SortedOrder {
+        vector<int> perm;
+        uint64_t    loadGen = UINT64_MAX;
+        const char* algo    = "";
+    };
+    SortedOrder sortedBy[FIELD_COUNT];
+    vector<strsort::PrefixKey> keyBuf, keyScratch;   // sort keys + merge buffer, reused across sorts
+    vector<int> keyOrder;            // last multi-column order
+
+    // lazy top-K view: perm[0, ready) is in final order and every row in
+    // perm[ready, n) sorts after it; active while idx points at perm
+    struct TopKView {
+        vector<strsort::PrefixKey> keys;
+        vector<int>                perm;
+        size_t                     ready = 0;
+        bool                       asc   = true;
+    };
+    mutable TopKView view;
+    static constexpr size_t TOPK_MIN = 256;   // smallest extension of the view
     static const char* NAMES[4];
 
     static int indexOf(const string& ch) {
@@ -176,6 +255,55 @@ class ArrayStore {
         return -1;
     }
 private:
+    // k-th row of the current order; descending is the ascending
+    // permutation read back to front
+    int ord(int k) const { return idx[desc ? n - 1 - k : k]; }
+
+    // Serves a repeat sort of f from its cached permutation in O(1).
+    bool useCachedOrder(Field f, bool asc, const char* what) {
+        SortedOrder& s = sortedBy[int(f)];
+        if (s.loadGen != loadGen) return false;
+        idx  = s.perm.data();
+        desc = !asc;
+        ++gen;
+        ++cachedSorts;
+        cout << "[Array] " << what << " " << fieldName(f) << " (" << (asc ? "A-Z" : "Z-A")
+             << ") - cached order from " << s.algo << "\n";
+        return true;
+    }
+    int* startOrder(Field f) {
+        vector<int>& p = sortedBy[int(f)].perm;
+        p.resize(n);
+        iota(p.begin(), p.end(), 0);
+        return p.data();
+    }
+    void adoptOrder(Field f, bool asc, const char* algo) {
+        SortedOrder& s = sortedBy[int(f)];
+        s.loadGen = loadGen;
+        s.algo    = algo;
+        idx  = s.perm.data();
+        desc = !asc;
+        ++gen;
+    }
+
+    void buildIdIndex() {
+        auto t0 = chrono::high_resolution_clock::now();
+        idIndex.build(uint32_t(n), [this](uint32_t r) -> const string& { return A[r].transaction_id; });
+        auto t1 = chrono::high_resolution_clock::now();
+        cout << "[Array] ID index: " << idIndex.size() << " keys, "
+             << idIndex.memoryBytes() / (1024.0 * 1024.0) << " MB (load " << idIndex.loadFactor()
+             << "), built in " << chrono::duration<double, milli>(t1 - t0).count() << " ms\n";
+    }
+
+    void reportFilters() const {
+        for (Field f : { Field::transaction_id, Field::sender_account, Field::receiver_account, Field::location }) {
+            const BlockedBloomFilter& b = filters.filter(f);
+            cout << "[Array] Bloom filter " << fieldName(f) << ": "
+                 << b.memoryBytes() / (1024.0 * 1024.0) << " MB, FPR "
+                 << b.estimatedFpr() * 100 << "% est / " << b.measuredFpr() * 100 << "% measured\n";
+        }
+    }
+
     int partitionIdx(int idx[], int low, int high) {
         auto pivot = A[idx[high]].location;
         int i = low - 1;
@@ -188,45 +316,91 @@ private:
         return i+1;
     }
 
-    void quickSortIdx(int idx[], int low, int high) {
+    auto compareLocation() const {
+        return [this](int x, int y){ return A[x].location.compare(A[y].location); };
+    }
+    auto locationKey() const {
+        return [this](int r) -> const string& { return A[r].location; };
+    }
+
+    // (location, row) order of prefix keys: equal locations keep row
+    // order, so unstable sorts produce the same permutation as stable ones
+    // and a cached order does not depend on the algorithm that built it
+    auto comparePrefixedLocation() const {
+        return [this](const strsort::PrefixKey& x, const strsort::PrefixKey& y) {
+            int c = strsort::comparePrefixed(x, y, locationKey());
+            return c ? c : (x.row > y.row) - (x.row < y.row);
+        };
+    }
+
+    // 3-way introsort of (prefix, row) keys; strings only on prefix ties.
+    // Median/ninther pivots, a loop on the larger side and a heap-sort
+    // fallback keep sorted extracts from going quadratic or deep.
+    void quickSortIdx(strsort::PrefixKey k[], int low, int high) {
         if (low >= high) return;
-        string pivot = A[idx[low]].location;
+        psort::quickSort3(k + low, size_t(high - low + 1), comparePrefixedLocation());
+    }
 
-        int lt = low, i = low, gt = high;
-        while (i <= gt) {
-            if      (A[idx[i]].location <  pivot) swap(idx[lt++], idx[i++]);
-            else if (A[idx[i]].location >  pivot) swap(idx[i]    , idx[gt--]);
-            else                                   ++i;
+    bool viewActive() const { return !view.perm.empty() && idx == view.perm.data(); }
+
+    // Makes ord(0..k-1) final under a top-K view (no-op otherwise). The
+    // ordered prefix at least doubles per extension (nth_element, then a
+    // sort of the new slice); past a quarter of the rows the rest is
+    // simply sorted.
+    void ensureOrdered(size_t k) const {
+        if (!viewActive() || k <= view.ready) return;
+        size_t total  = view.keys.size();
+        size_t target = max({ k, 2 * view.ready, TOPK_MIN });
+        auto cmp    = comparePrefixedLocation();
+        auto before = [&](const strsort::PrefixKey& x, const strsort::PrefixKey& y) {
+            int c = cmp(x, y);
+            return view.asc ? c < 0 : c > 0;
+        };
+        auto from = view.keys.begin() + view.ready;
+        if (target >= total / 4) {
+            sort(from, view.keys.end(), before);
+            target = total;
+        } else {
+            nth_element(from, view.keys.begin() + target, view.keys.end(), before);
+            sort(from, view.keys.begin() + target, before);
         }
-        quickSortIdx(idx, low,    lt - 1);
-        quickSortIdx(idx, gt + 1, high);
+        for (size_t i = view.ready; i < target; ++i) view.perm[i] = int(view.keys[i].row);
+        view.ready = target;
     }
 
-    void merge(int idx[], int tmp[], int l, int m, int r) {
-        int i = l, j = m+1, k = l;
-        while (i <= m && j <= r) {
-            if (A[idx[i]].location <= A[idx[j]].location)
-            tmp[k++] = idx[i++];
-            else
-            tmp[k++] = idx[j++];
-        }
-        while (i <= m) tmp[k++] = idx[i++];
-        while (j <= r) tmp[k++] = idx[j++];
-        for (int t = l; t <= r; ++t) idx[t] = tmp[t];
+    // location keys of p[0, n) into keyBuf, in p's order
+    strsort::PrefixKey* locationKeys(const int* p) {
+        keyBuf.resize(n);
+        for (int i = 0; i < n; ++i) keyBuf[i] = strsort::prefixKey(A[p[i]].location, uint32_t(p[i]));
+        return keyBuf.data();
+    }
+    void storeRows(const strsort::PrefixKey* k, int* p) const {
+        for (int i = 0; i < n; ++i) p[i] = int(k[i].row);
     }
 
-    void mergeSort(int idx[], int tmp[], int l, int r) {
-        if (l >= r) return;
-        int m = l + (r-l)/2;
-        mergeSort(idx, tmp, l,   m);
-        mergeSort(idx, tmp, m+1, r);
-        merge(idx, tmp, l, m, r);
+    // stable sort of p[0, n) with the comparator compiled for keys
+    bool keySort(int* p, const vector<SortKey>& keys) {
+        vector<const Transaction*> rowp(n);
+        for (int i = 0; i < n; ++i) rowp[i] = &A[i];
+        return sortRowsByKeys(reinterpret_cast<uint32_t*>(p), size_t(n), rowp.data(), keys, sharedPool());
+    }
+
+    // stable parallel merge sort of idx[0, n) by location, on prefix keys
+    void mergeSort(int idx[], unsigned threads = 0) {
+        strsort::PrefixKey* k = locationKeys(idx);
+        keyScratch.resize(n);
+        auto cmp = comparePrefixedLocation();
+        psort::parallelMergeSort(k, keyScratch.data(), size_t(n),
+            [&](const strsort::PrefixKey& x, const strsort::PrefixKey& y){ return cmp(x, y) < 0; },
+            sharedPool(threads));
+        storeRows(k, idx);
     }
 
 public:
     ArrayStore()
       : A(new Transaction[MAX_TRANSACTIONS])
-      , idx(new int[MAX_TRANSACTIONS])
+      , idxBuf(new int[MAX_TRANSACTIONS])
+      , idx(idxBuf)
       , n(0)
       , channels{ TransactionList(),TransactionList(),
                   TransactionList(),TransactionList() }
@@ -234,13 +408,23 @@ public:
 
     ~ArrayStore() {
         delete[] A;
-        delete[] idx;
+        delete[] idxBuf;
     }
 
      void loadAllFromCSV(const string& fn) {
         n = 0;
         for (int i = 0; i < 4; ++i) channels[i].clear();
         lastChannel.clear();
+        ++gen;
+        ++loadGen;
+        idx  = idxBuf;
+        desc = false;
+        for (auto& s : sortedBy) s = SortedOrder();
+        bix.clear();
+        filters.clear();
+        numIdx.clear();
+        acctIdx.clear();
+        for (auto& s : sortedCat) s.clear();
 
         ifstream f(fn);
         if (!f.is_open()) {
@@ -283,16 +467,21 @@ public:
 
             channels[ci].push(T);
 
+            bix.add(n, T);
             A[n]   = T;
             idx[n] = n;
             ++n;
         }
 
         iota(idx, idx + n, 0);
+        filters.build(size_t(n), [this](uint32_t r) -> const Transaction& { return A[r]; });
+        locTrie.build(bix.column(Field::location).values);
         cout << "[Array] Loaded " << n << " rows (full) | Distribution: ";
         for (int i = 0; i < 4; ++i)
             cout << NAMES[i] << ":" << channels[i].count << " ";
         cout << "\n";
+        buildIdIndex();
+        reportFilters();
     }
 
     void loadFromCSV(const string& fn, const string& channel) {
@@ -301,6 +490,16 @@ public:
         }
         lastChannel = channel;
         n = 0;
+        ++gen;
+        ++loadGen;
+        idx  = idxBuf;
+        desc = false;
+        for (auto& s : sortedBy) s = SortedOrder();
+        bix.clear();
+        filters.clear();
+        numIdx.clear();
+        acctIdx.clear();
+        for (auto& s : sortedCat) s.clear();
 
         int sel = indexOf(channel);
         if (sel < 0) {
@@ -349,6 +548,7 @@ public:
             channels[ci].push(T);
 
             if (ci == sel && n < MAX_TRANSACTIONS) {
+                bix.add(n, T);
                 A[n] = T;
                 idx[n] = n;
                 ++n;
@@ -356,11 +556,15 @@ public:
         }
 
         iota(idx, idx + n, 0);
+        filters.build(size_t(n), [this](uint32_t r) -> const Transaction& { return A[r]; });
+        locTrie.build(bix.column(Field::location).values);
         cout << "[Array] Loaded " << n << " rows | Payment-Channel: " << channel << " | Distribution: ";
         for (int i = 0; i < 4; ++i) {
             cout << NAMES[i] << ":" << channels[i].count << " ";
         }
         cout << "\n";
+        buildIdIndex();
+        reportFilters();
     }
 
     int size() const { return n; }
@@ -374,81 +578,496 @@ public:
 
     // linear searches
     TransactionList getByTransactionType(const string& tp) const {
+        ensureOrdered(size_t(n));
         TransactionList out;
         for (int k = 0; k < n; ++k) {
-            const auto &t = A[idx[k]];
+            const auto &t = A[ord(k)];
             if (t.transaction_type == tp)
                 out.push(t);
         }
         return out;
     }
     TransactionList getByLocation(const string& loc) const {
+        ensureOrdered(size_t(n));
         TransactionList out;
         for (int k = 0; k < n; ++k) {
-            const auto &t = A[idx[k]];
+            const auto &t = A[ord(k)];
             if (t.location == loc)
                 out.push(t);
         }
         return out;
     }
 
-    // binary searches
-    TransactionList searchByTransactionTypeBinary(const string& key) {
-        iota(idx, idx+n, 0);
-        stable_sort(idx, idx+n,
-            [&](int a,int b){ return A[a].transaction_type < A[b].transaction_type; });
-        int lo=0, hi=n;
-        while (lo<hi) {
-            int mid=(lo+hi)/2;
-            if (A[idx[mid]].transaction_type < key) lo=mid+1;
-            else hi=mid;
-        }
+    // vectorized linear searches over the dictionary-code columns (row order);
+    // ids, if given, receives the matching row ids in result order
+    TransactionList scanVectorized(Field f, const string& key, ScanStats& st,
+                                   vector<uint32_t>* ids = nullptr) const {
+        vector<uint64_t> sel = bix.scanCodes(f, {key}, &st);
         TransactionList out;
-        while (lo<n && A[idx[lo]].transaction_type==key)
-            out.push(A[idx[lo++]]);
+        for (size_t w = 0; w < sel.size(); ++w)
+            for (uint64_t bits = sel[w]; bits; bits &= bits - 1) {
+                uint32_t r = uint32_t(w * 64 + simd::countTrailingZeros64(bits));
+                out.push(A[r]);
+                if (ids) ids->push_back(r);
+            }
         return out;
     }
-    TransactionList searchByLocationBinary(const string& key) {
-        iota(idx, idx+n, 0);
-        stable_sort(idx, idx+n,
-            [&](int a,int b){ return A[a].location < A[b].location; });
-        int lo=0, hi=n;
-        while (lo<hi) {
-            int mid=(lo+hi)/2;
-            if (A[idx[mid]].location < key) lo=mid+1;
-            else hi=mid;
+    TransactionList getByTransactionTypeVectorized(const string& tp, ScanStats& st,
+                                                   vector<uint32_t>* ids = nullptr) const {
+        return scanVectorized(Field::transaction_type, tp, st, ids);
+    }
+    TransactionList getByLocationVectorized(const string& loc, ScanStats& st,
+                                            vector<uint32_t>* ids = nullptr) const {
+        return scanVectorized(Field::location, loc, st, ids);
+    }
+
+    // parallel linear searches: idx[0, n) split into chunks across the pool,
+    // per-chunk matches concatenated (and copied out in parallel) in idx order
+    template <class Match>
+    TransactionList parallelScan(Match match, ThreadPool& pool, vector<uint32_t>* ids = nullptr) const {
+        ensureOrdered(size_t(n));   // workers read idx concurrently
+        size_t chunks = size_t(pool.size()) * 4;
+        vector<vector<uint32_t>> hits(chunks);
+        pool.parallelFor(size_t(n), chunks, [&](size_t c, size_t b, size_t e) {
+            for (size_t k = b; k < e; ++k) {
+                int r = ord(int(k));
+                if (match(A[r])) hits[c].push_back(uint32_t(r));
+            }
+        });
+
+        vector<size_t> offset(chunks + 1, 0);
+        for (size_t c = 0; c < chunks; ++c) offset[c+1] = offset[c] + hits[c].size();
+        TransactionList out(max<int>(1, int(offset[chunks])));
+        out.count = int(offset[chunks]);
+        if (ids) ids->resize(offset[chunks]);
+        pool.parallelFor(chunks, chunks, [&](size_t c, size_t, size_t) {
+            for (size_t i = 0; i < hits[c].size(); ++i) out.data[offset[c] + i] = A[hits[c][i]];
+            if (ids) copy(hits[c].begin(), hits[c].end(), ids->begin() + offset[c]);
+        });
+        return out;
+    }
+    TransactionList getByTransactionTypeParallel(const string& tp, ThreadPool& pool,
+                                                 vector<uint32_t>* ids = nullptr) const {
+        return parallelScan([&](const Transaction& t){ return t.transaction_type == tp; }, pool, ids);
+    }
+    TransactionList getByLocationParallel(const string& loc, ThreadPool& pool,
+                                          vector<uint32_t>* ids = nullptr) const {
+        return parallelScan([&](const Transaction& t){ return t.location == loc; }, pool, ids);
+    }
+
+    // binary searches: Eytzinger-ordered value ranks, built once per load
+    // instead of re-sorting idx on every search; returns build ms (0 if cached)
+    double ensureSortedIndex(Field f) const {
+        if (sortedCat[int(f)].built()) return 0;
+        auto t0 = chrono::high_resolution_clock::now();
+        sortedCat[int(f)].build(bix.column(f));
+        auto t1 = chrono::high_resolution_clock::now();
+        return chrono::duration<double, milli>(t1 - t0).count();
+    }
+    vector<uint32_t> binaryRows(Field f, const string& key) const {
+        ensureSortedIndex(f);
+        const EytzingerIndex& ix = sortedCat[int(f)];
+        auto pr = ix.range(key);
+        vector<uint32_t> out;
+        out.reserve(pr.second - pr.first);
+        for (size_t i = pr.first; i < pr.second; ++i) out.push_back(ix.rowAt(i));
+        return out;
+    }
+    TransactionList searchBinary(Field f, const string& key) const {
+        vector<uint32_t> ids = binaryRows(f, key);
+        TransactionList out(max<int>(1, int(ids.size())));
+        for (uint32_t r : ids) out.push(A[r]);
+        return out;
+    }
+    TransactionList searchByTransactionTypeBinary(const string& key) const {
+        return searchBinary(Field::transaction_type, key);
+    }
+    TransactionList searchByLocationBinary(const string& key) const {
+        return searchBinary(Field::location, key);
+    }
+
+    // ns per lookup of the old lo/hi loop over strings through idx, the same
+    // loop over 32-bit ranks, and the Eytzinger layout, at growing prefixes of A
+    void benchmarkBinarySearch(Field f) const {
+        const BitmapIndex::Column& col = bix.column(f);
+        if (!n || col.values.empty()) { cout << "(no records)\n"; return; }
+
+        const int Q = 1 << 18;
+        mt19937 rng(42);
+        vector<uint32_t> qcode(Q);
+        for (auto& q : qcode) q = rng() % col.values.size();
+
+        vector<int> sizes;
+        for (int m : { 10000, 100000, 1000000, n })
+            if (m <= n && (sizes.empty() || m > sizes.back())) sizes.push_back(m);
+
+        cout << "\n" << left << setw(10) << "rows" << right
+             << setw(16) << "lo/hi string" << setw(14) << "lo/hi rank"
+             << setw(14) << "eytzinger" << "   (ns/lookup, " << Q << " lookups)\n";
+        for (int m : sizes) {
+            vector<int> ord(m);
+            iota(ord.begin(), ord.end(), 0);
+            stable_sort(ord.begin(), ord.end(),
+                [&](int a, int b){ return *stringField(A[a], f) < *stringField(A[b], f); });
+            EytzingerIndex ix;
+            ix.build(col, uint32_t(m));
+            const vector<uint32_t>& keys = ix.sortedKeys();
+            vector<uint32_t> qrank(Q);
+            for (int i = 0; i < Q; ++i) qrank[i] = uint32_t(ix.rankOf(col.values[qcode[i]]));
+
+            uint64_t sumStr = 0, sumRank = 0, sumEytz = 0;
+            auto t0 = chrono::high_resolution_clock::now();
+            for (int i = 0; i < Q; ++i) {
+                const string& key = col.values[qcode[i]];
+                int lo = 0, hi = m;
+                while (lo < hi) {
+                    int mid = (lo + hi) / 2;
+                    if (*stringField(A[ord[mid]], f) < key) lo = mid + 1;
+                    else hi = mid;
+                }
+                sumStr += lo;
+            }
+            auto t1 = chrono::high_resolution_clock::now();
+            for (int i = 0; i < Q; ++i) {
+                uint32_t lo = 0, hi = uint32_t(m);
+                while (lo < hi) {
+                    uint32_t mid = (lo + hi) / 2;
+                    if (keys[mid] < qrank[i]) lo = mid + 1;
+                    else hi = mid;
+                }
+                sumRank += lo;
+            }
+            auto t2 = chrono::high_resolution_clock::now();
+            for (int i = 0; i < Q; ++i) sumEytz += ix.layout().lowerBound(qrank[i]);
+            auto t3 = chrono::high_resolution_clock::now();
+
+            auto ns = [&](chrono::high_resolution_clock::time_point a,
+                          chrono::high_resolution_clock::time_point b) {
+                return chrono::duration<double, nano>(b - a).count() / Q;
+            };
+            cout << left << setw(10) << m << right << fixed << setprecision(1)
+                 << setw(16) << ns(t0, t1) << setw(14) << ns(t1, t2) << setw(14) << ns(t2, t3);
+            if (sumStr != sumRank || sumRank != sumEytz) cout << "   (result mismatch!)";
+            cout << "\n";
         }
-        TransactionList out;
-        while (lo<n && A[idx[lo]].location==key)
-            out.push(A[idx[lo++]]);
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+
+    // ms per location sort of the load order for each algorithm, bypassing
+    // the sorted-order cache; the store's current order is left untouched
+    void benchmarkLocationSort(unsigned threads = 0) {
+        if (!n) { cout << "(no records)\n"; return; }
+        unsigned workers = threads ? threads : ThreadPool::hardwareThreads();
+        sharedPool(threads);           // start both pools up front so thread
+        sharedStealingPool(threads);   // startup is not timed as sort time
+        vector<int> p(n), input(n);
+        iota(input.begin(), input.end(), 0);
+
+        auto timeIt = [&](const string& name, function<void(int*)> sortFn) {
+            p = input;
+            auto t0 = chrono::high_resolution_clock::now();
+            sortFn(p.data());
+            auto t1 = chrono::high_resolution_clock::now();
+            bool ok = true;
+            for (int k = 1; k < n && ok; ++k) ok = A[p[k-1]].location <= A[p[k]].location;
+            cout << left << setw(36) << name << right << fixed << setprecision(2)
+                 << setw(12) << chrono::duration<double, milli>(t1 - t0).count()
+                 << (ok ? "" : "   (not sorted!)") << "\n";
+        };
+
+        cout << "\n" << left << setw(36) << "algorithm" << right << setw(12) << "ms"
+             << "   (" << n << " rows, location)\n";
+        timeIt("QuickSort (3-way, string compares)", [&](int* q){ psort::quickSort3(q, size_t(n), compareLocation()); });
+        timeIt("QuickSort (3-way, prefix keys)", [&](int* q){
+            quickSortIdx(locationKeys(q), 0, n-1);
+            storeRows(keyBuf.data(), q);
+        });
+        timeIt("QuickSort (task-parallel, " + to_string(workers) + " thr)", [&](int* q){
+            psort::parallelQuickSort(locationKeys(q), size_t(n), comparePrefixedLocation(), sharedStealingPool(threads));
+            storeRows(keyBuf.data(), q);
+        });
+        timeIt("MergeSort (string compares, " + to_string(workers) + " thr)", [&](int* q){
+            vector<int> tmp(n);
+            psort::parallelMergeSort(q, tmp.data(), size_t(n),
+                [this](int x, int y){ return A[x].location < A[y].location; }, sharedPool(threads));
+        });
+        timeIt("MergeSort (prefix keys, " + to_string(workers) + " thr)", [&](int* q){ mergeSort(q, threads); });
+        timeIt("MSD radix sort", [&](int* q){ strsort::msdRadixSort(q, size_t(n), locationKey()); });
+        timeIt("Counting sort (dictionary ranks)", [&](int* q){
+            strsort::countingSortByCode(q, bix.column(Field::location), size_t(n));
+        });
+        auto adaptive = [&](int* q){
+            strsort::PrefixKey* k = locationKeys(q);
+            auto cmp = comparePrefixedLocation();
+            adsort::adaptiveSort(k, size_t(n),
+                [&](const strsort::PrefixKey& x, const strsort::PrefixKey& y){ return cmp(x, y) < 0; });
+            storeRows(k, q);
+        };
+        timeIt("Adaptive merge (natural runs)", adaptive);
+
+        // same sorts on an extract that is already almost in location order
+        strsort::msdRadixSort(input.data(), size_t(n), locationKey());
+        mt19937 rng(42);
+        for (int s = 0; s < n / 100; ++s) swap(input[rng() % n], input[rng() % n]);
+        cout << "\n" << left << setw(36) << "nearly sorted input" << right << setw(12) << "ms"
+             << "   (1% of rows displaced)\n";
+        timeIt("QuickSort (3-way, prefix keys)", [&](int* q){
+            quickSortIdx(locationKeys(q), 0, n-1);
+            storeRows(keyBuf.data(), q);
+        });
+        timeIt("MergeSort (prefix keys, " + to_string(workers) + " thr)", [&](int* q){ mergeSort(q, threads); });
+        timeIt("Adaptive merge (natural runs)", adaptive);
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+
+    // bitmap-index searches (row ids = positions in A)
+    Bitmap searchBitmap(const vector<BitmapPredicate>& preds) const {
+        return bix.evaluate(preds);
+    }
+    const BitmapIndex& bitmapIndex() const { return bix; }
+
+    // sorted numeric index for f, built on first use; returns build ms (0 if cached)
+    double ensureNumericIndex(Field f) const {
+        if (numIdx[f].built()) return 0;
+        auto t0 = chrono::high_resolution_clock::now();
+        numIdx[f].build(f, uint32_t(n), [this](uint32_t r) -> const Transaction& { return A[r]; });
+        auto t1 = chrono::high_resolution_clock::now();
+        return chrono::duration<double, milli>(t1 - t0).count();
+    }
+
+    // range search on a numeric column, inclusive bounds, ascending by value
+    TransactionList searchByRange(Field f, bool hasLo, double lo, bool hasHi, double hi) const {
+        ensureNumericIndex(f);
+        const SortedNumericIndex& ix = numIdx[f];
+        auto pr = ix.range(hasLo, lo, true, hasHi, hi, true);
+        TransactionList out(max<int>(1, int(pr.second - pr.first)));
+        for (size_t i = pr.first; i < pr.second; ++i) out.push(A[ix.rowAt(i)]);
         return out;
     }
 
-    // quick-sort
+    // query engine: plans q in place, fills plan with its EXPLAIN text
+    Bitmap runQuery(QueryNode& q, string& plan) const {
+        vector<Field> numeric;
+        collectNumericFields(q, numeric);
+        for (Field f : numeric) ensureNumericIndex(f);
+
+        QueryIndexes ix;
+        ix.bitmaps = &bix;
+        ix.numeric = &numIdx;
+        ix.ids     = &idIndex;
+        auto eng = makeQueryEngine(ix, uint32_t(n),
+            [this](uint32_t r) -> const Transaction& { return A[r]; });
+        plan = eng.prepare(q);
+        return eng.execute(q);
+    }
+
+    // trie expansion of a location query, resolved through the bitmap index
+    vector<string> expandLocation(const string& q, DictionaryTrie::Mode m, int maxEdits) const {
+        return locTrie.expand(q, m, maxEdits);
+    }
+    Bitmap locationRows(const vector<string>& values) const {
+        return bix.lookup(Field::location, values);
+    }
+
+    // point lookup through the transaction_id hash index
+    TransactionList searchById(const string& id) const {
+        TransactionList out(1);
+        idIndex.findAll(id, [this](uint32_t r) -> const string& { return A[r].transaction_id; },
+                        [&](uint32_t r){ out.push(A[r]); });
+        return out;
+    }
+
+    // account history through the CSR index; returns build ms (0 if cached)
+    double ensureAccountIndex() const {
+        if (acctIdx.built()) return 0;
+        auto t0 = chrono::high_resolution_clock::now();
+        acctIdx.build(uint32_t(n), [this](uint32_t r) -> const Transaction& { return A[r]; });
+        auto t1 = chrono::high_resolution_clock::now();
+        return chrono::duration<double, milli>(t1 - t0).count();
+    }
+    vector<uint32_t> accountRows(const string& acct, AccountIndex::Direction d) const {
+        ensureAccountIndex();
+        return acctIdx.lookup(acct, d, [this](uint32_t r) -> const Transaction& { return A[r]; });
+    }
+    size_t accountIndexBytes() const { return acctIdx.memoryBytes(); }
+
+    uint64_t generation() const { return gen; }
+    uint64_t cacheServedSorts() const { return cachedSorts; }
+
+    // false = key certainly absent from f, no scan needed
+    bool mayContain(Field f, const string& key) const { return filters.mayContain(f, key); }
+
+    // aggregates straight over postings / rows, without a TransactionList
+    const Bitmap* postings(Field f, const string& key) const { return bix.column(f).find(key); }
+    Aggregate aggregate(const Bitmap& ids, bool countOnly) const {
+        return aggregateRows(ids, [this](uint32_t r) -> const Transaction& { return A[r]; }, countOnly);
+    }
+    Aggregate aggregateTable(bool countOnly) const {
+        return aggregateAll(uint32_t(n), [this](uint32_t r) -> const Transaction& { return A[r]; }, countOnly);
+    }
+
+    // batch search: one group of row ids per key (keys must be distinct).
+    // Scan = one pass over the rows probing a hash index built over the
+    // keys; otherwise one index probe per key. Groups are in row order
+    // either way.
+    vector<vector<uint32_t>> batchSearch(Field f, const vector<string>& keys, bool scan) const {
+        vector<vector<uint32_t>> groups(keys.size());
+        auto keyAt = [&](uint32_t i) -> const string& { return keys[i]; };
+        if (scan) {
+            HashIndex batch;
+            batch.build(uint32_t(keys.size()), keyAt);
+            for (uint32_t r = 0; r < uint32_t(n); ++r) {
+                int64_t g = batch.find(*stringField(A[r], f), keyAt);
+                if (g >= 0) groups[g].push_back(r);
+            }
+            return groups;
+        }
+        for (size_t g = 0; g < keys.size(); ++g) {
+            if (!filters.mayContain(f, keys[g])) continue;
+            if (f == Field::transaction_id)
+                idIndex.findAll(keys[g], [this](uint32_t r) -> const string& { return A[r].transaction_id; },
+                                [&](uint32_t r){ groups[g].push_back(r); });
+            else if (f == Field::sender_account || f == Field::receiver_account)
+                groups[g] = accountRows(keys[g], f == Field::sender_account ? AccountIndex::OUTGOING
+                                                                            : AccountIndex::INCOMING);
+            else if (const Bitmap* p = bix.column(f).find(keys[g])) {
+                p->forEach([&](uint32_t r){ groups[g].push_back(r); });
+                continue;   // bitmaps already iterate in row order
+            }
+            sort(groups[g].begin(), groups[g].end());   // hash / timestamp order -> row order
+        }
+        return groups;
+    }
+
+    // result cursors; cursorWhere scans idx lazily, one match per pull
+    ResultCursor cursorWhere(Field f, const string& key) const {
+        int k = 0;
+        return ResultCursor([this, f, key, k]() mutable -> int64_t {
+            while (k < n) {
+                ensureOrdered(size_t(k) + 1);
+                int r = ord(k++);
+                if (*stringField(A[r], f) == key) return r;
+            }
+            return -1;
+        }, [this](uint32_t r) -> const Transaction& { return A[r]; }, READAHEAD_ROWS);
+    }
+    ResultCursor cursorOver(vector<uint32_t> ids) const {
+        return ResultCursor::overIds(std::move(ids),
+            [this](uint32_t r) -> const Transaction& { return A[r]; });
+    }
+    ResultCursor cursorOver(const Bitmap& rows) const {
+        vector<uint32_t> ids;
+        ids.reserve(size_t(rows.cardinality()));
+        rows.forEach([&](uint32_t r){ ids.push_back(r); });
+        return cursorOver(std::move(ids));
+    }
+
+    // quick-sort (repeat sorts reuse the cached permutation)
     void sortByLocation(bool asc = true) {
-        for (int i = 0; i < n; ++i) idx[i] = i;
-        quickSortIdx(idx, 0, n-1);       // your 3-way on idx[]
-        if (!asc) std::reverse(idx, idx+n);
+        if (useCachedOrder(Field::location, asc, "Index-QuickSort")) return;
+        int* p = startOrder(Field::location);
+        quickSortIdx(locationKeys(p), 0, n-1);
+        storeRows(keyBuf.data(), p);
+        adoptOrder(Field::location, asc, "QuickSort");
         cout<<"[Array] Index-QuickSort Location ("<<(asc?"A-Z":"Z-A")<<")\n";
     }
 
-    // merge-sort
-    void sortByLocationMerge(bool asc = true) {
-        for (int i = 0; i < n; ++i) idx[i] = i;
-        
-        int* tmp = new int[n];
-        mergeSort(idx, tmp, 0, n-1);
-        // delete[] tmp;
+    // MSD radix sort: byte-wise buckets, no string compares above the cutoff
+    void sortByLocationRadix(bool asc = true) {
+        if (useCachedOrder(Field::location, asc, "Index-Radix")) return;
+        int* p = startOrder(Field::location);
+        strsort::msdRadixSort(p, size_t(n), locationKey());
+        adoptOrder(Field::location, asc, "RadixSort");
+        cout << "[Array] Index-Radix Location (" << (asc ? "A-Z" : "Z-A") << ")\n";
+    }
+
+    // counting sort by dictionary rank: two linear passes over the codes, stable
+    void sortByCounting(Field f, bool asc = true) {
+        if (useCachedOrder(f, asc, "Index-Counting")) return;
+        int* p = startOrder(f);
+        strsort::countingSortByCode(p, bix.column(f), size_t(n));
+        adoptOrder(f, asc, "CountingSort");
+        cout << "[Array] Index-Counting " << fieldName(f) << " (" << (asc ? "A-Z" : "Z-A") << ")\n";
+    }
 
-        if (!asc) {
-        for (int i = 0; i < n/2; ++i)
-            std::swap(idx[i], idx[n-1-i]);
+    // stable sort by up to MAX_SORT_KEYS columns; multi-column orders are
+    // kept in keyOrder and ties stay in load order under asc and desc keys.
+    // A single column shares that column's cached order, so a single desc
+    // key returns the stable ascending order reversed (ties in reverse load
+    // order), like every other Z-A sort
+    void sortByKeys(const vector<SortKey>& keys) {
+        bool adaptive;
+        if (keys.size() == 1) {
+            Field f = keys[0].field;
+            if (useCachedOrder(f, !keys[0].desc, "Index-KeySort")) return;
+            adaptive = keySort(startOrder(f), { SortKey{ f, false } });
+            adoptOrder(f, !keys[0].desc, "KeySort");
+        } else {
+            keyOrder.resize(n);
+            iota(keyOrder.begin(), keyOrder.end(), 0);
+            adaptive = keySort(keyOrder.data(), keys);
+            idx  = keyOrder.data();
+            desc = false;
+            ++gen;
         }
+        cout << "[Array] Index-KeySort (" << sortKeysLabel(keys) << ")"
+             << (adaptive ? " - adaptive merge, input mostly in order" : "") << "\n";
+    }
+
+    // lazy top-K view: orders the first rows now and the rest only as
+    // display pages forward; scans, export and deep jumps finish the sort
+    void sortByLocationTopK(bool asc = true) {
+        if (useCachedOrder(Field::location, asc, "TopK-View")) return;
+        view = TopKView();
+        view.asc = asc;
+        view.keys.resize(n);
+        for (int i = 0; i < n; ++i) view.keys[i] = strsort::prefixKey(A[i].location, uint32_t(i));
+        view.perm.assign(n, 0);
+        idx  = view.perm.data();
+        desc = false;
+        ++gen;
+        ensureOrdered(TOPK_MIN);
+        cout << "[Array] TopK-View Location (" << (asc ? "A-Z" : "Z-A") << "): first "
+             << view.ready << " of " << n << " rows ordered\n";
+    }
+
+    // task-parallel 3-way quick-sort on the work-stealing pool
+    void sortByLocationParallel(bool asc = true, unsigned threads = 0) {
+        if (useCachedOrder(Field::location, asc, "Parallel-QuickSort")) return;
+        int* p = startOrder(Field::location);
+        psort::parallelQuickSort(locationKeys(p), size_t(n), comparePrefixedLocation(), sharedStealingPool(threads));
+        storeRows(keyBuf.data(), p);
+        adoptOrder(Field::location, asc, "ParallelQuickSort");
+        cout << "[Array] Parallel-QuickSort Location ("
+             << (asc ? "A-Z" : "Z-A") << ", " << sharedStealingPool(threads).size() << " threads)\n";
+    }
 
+    // merge-sort
+    void sortByLocationMerge(bool asc = true) {
+        if (useCachedOrder(Field::location, asc, "Index-Merge")) return;
+        int* p = startOrder(Field::location);
+        mergeSort(p);
+        adoptOrder(Field::location, asc, "MergeSort");
         cout << "[Array] Index-Merge Location ("
             << (asc ? "A-Z" : "Z-A") << ")\n";
     }
 
+    // adaptive merge sort: natural runs of the load order, galloping merges
+    void sortByLocationAdaptive(bool asc = true) {
+        if (useCachedOrder(Field::location, asc, "Index-Adaptive")) return;
+        int* p = startOrder(Field::location);
+        strsort::PrefixKey* k = locationKeys(p);
+        auto cmp = comparePrefixedLocation();
+        adsort::Stats st = adsort::adaptiveSort(k, size_t(n),
+            [&](const strsort::PrefixKey& x, const strsort::PrefixKey& y){ return cmp(x, y) < 0; });
+        storeRows(k, p);
+        adoptOrder(Field::location, asc, "AdaptiveSort");
+        cout << "[Array] Index-Adaptive Location (" << (asc ? "A-Z" : "Z-A") << "): "
+             << st.runs << " runs, " << st.galloped << " rows galloped\n";
+    }
+
     void exportToJSON(const std::string& fn, const std::string& title) const {
         namespace fs = std::filesystem;
 
@@ -462,8 +1081,9 @@ public:
         header["title"] = title;
         j.push_back(header);
 
+        ensureOrdered(size_t(n));
         for (int i = 0; i < n; ++i) {
-            const auto& t = A[idx[i]];
+            const auto& t = A[ord(i)];
             json entry = {
                 {"transaction_id",    t.transaction_id},
                 {"payment_channel",   t.payment_channel},
@@ -504,8 +1124,11 @@ public:
                 << "| " << setw(12) << "Merchant\n"
                 << string(65, '-') << "\n";
 
+            ensureOrdered(size_t(end));   // a top-K view orders only what is shown
+            if (viewActive())
+                cout << "(top-K view: " << view.ready << " of " << n << " rows ordered)\n";
             for (int i = start; i < end; ++i) {
-            const auto& t = A[idx[i]];
+            const auto& t = A[ord(i)];
             cout << setw(10) << t.transaction_id
                 << "| " << setw(15) << t.transaction_type
                 << "| " << setw(13) << t.payment_channel
@@ -544,13 +1167,29 @@ public:
 
     void reset() {
         delete[] A;
-        delete[] idx;
+        delete[] idxBuf;
 
-        A   = new Transaction[MAX_TRANSACTIONS];
-        idx = new int[MAX_TRANSACTIONS];
+        A      = new Transaction[MAX_TRANSACTIONS];
+        idxBuf = new int[MAX_TRANSACTIONS];
 
         n = 0;
         lastChannel.clear();
+        ++gen;
+        ++loadGen;
+        idx  = idxBuf;
+        desc = false;
+        for (auto& s : sortedBy) s = SortedOrder();
+        vector<strsort::PrefixKey>().swap(keyBuf);
+        vector<strsort::PrefixKey>().swap(keyScratch);
+        vector<int>().swap(keyOrder);
+        view = TopKView();
+        bix.clear();
+        filters.clear();
+        numIdx.clear();
+        acctIdx.clear();
+        for (auto& s : sortedCat) s.clear();
+        locTrie.clear();
+        idIndex.clear();
         for (int i = 0; i < 4; ++i) {
         channels[i] = TransactionList();
         }
@@ -568,7 +1207,8 @@ class LinkedListStore {
     struct Node {
         Transaction d;
         Node*       next;
-        Node(const Transaction& x): d(x), next(nullptr) {}
+        uint32_t    row;     // position in rows[]
+        Node(const Transaction& x): d(x), next(nullptr), row(0) {}
     };
 
     Node* head;
@@ -576,6 +1216,28 @@ class LinkedListStore {
     int n;
     string lastChannel;
     TransactionList channels[4];
+    vector<Node*> rows;      // row id -> node, in load order (stable across sorts)
+    BitmapIndex bix;
+    mutable NumericIndexes numIdx;   // built on first range query
+    DictionaryTrie locTrie;          // distinct locations, rebuilt per load
+    HashIndex idIndex;               // transaction_id -> row, built at load
+    mutable AccountIndex acctIdx;    // sender/receiver CSR, built on first use
+    FieldFilters filters;            // Bloom filters for point-lookup columns, built after a load
+    uint64_t gen = 0;                // bumped whenever rows or list order change
+    uint64_t loadGen = 0;            // bumped on load/reset only
+    uint64_t cachedSorts = 0;        // sorts answered from sortedBy[] without sorting
+
+    // ascending node order per column, valid while loadGen matches; every
+    // sort starts from load order and is stable, so the order is the same
+    // whichever algorithm built it. Descending sorts reverse it.
+    struct SortedOrder {
+        vector<Node*> nodes;
+        uint64_t      loadGen = UINT64_MAX;
+        const char*   algo    = "";
+    };
+    SortedOrder sortedBy[FIELD_COUNT];
+    int  listField = -1;             // column the list is currently sorted by
+    bool listAsc   = true;
     static const char* NAMES[4];
 
     static int indexOf(const string& ch) {
@@ -584,38 +1246,99 @@ class LinkedListStore {
         return -1;
     }
 
-    // quicksort
-    Node* quickSortList(Node* h) {
-        if (!h || !h->next) return h;
-        string pivot = h->d.location;
-        Node *lH=nullptr,*lT=nullptr, *eH=nullptr,*eT=nullptr, *gH=nullptr,*gT=nullptr;
-        for (Node* cur=h; cur; ) {
-            Node* nx = cur->next; cur->next = nullptr;
-            if      (cur->d.location < pivot) {
-                if (!lH) lH=lT=cur;
-                else      lT->next=cur, lT=cur;
+    void buildIdIndex() {
+        auto t0 = chrono::high_resolution_clock::now();
+        idIndex.build(uint32_t(rows.size()),
+            [this](uint32_t r) -> const string& { return rows[r]->d.transaction_id; });
+        auto t1 = chrono::high_resolution_clock::now();
+        cout << "[LL] ID index: " << idIndex.size() << " keys, "
+             << idIndex.memoryBytes() / (1024.0 * 1024.0) << " MB (load " << idIndex.loadFactor()
+             << "), built in " << chrono::duration<double, milli>(t1 - t0).count() << " ms\n";
+    }
+
+    void reportFilters() const {
+        for (Field f : { Field::transaction_id, Field::sender_account, Field::receiver_account, Field::location }) {
+            const BlockedBloomFilter& b = filters.filter(f);
+            cout << "[LL] Bloom filter " << fieldName(f) << ": "
+                 << b.memoryBytes() / (1024.0 * 1024.0) << " MB, FPR "
+                 << b.estimatedFpr() * 100 << "% est / " << b.measuredFpr() * 100 << "% measured\n";
+        }
+    }
+
+    // quicksort (introspective): 3-way partition around the median of the
+    // first, middle and last node; the shorter side recurses and the
+    // longer one loops, with finished blocks collected in front of (pre)
+    // or behind (post) it. A part still unsorted after 2*log2(len)
+    // partitions is merge-sorted instead.
+    Node* quickSortList(Node* h, size_t len, int depth, Node** last) {
+        Node  *preH = nullptr, *preT = nullptr, *post = nullptr, *postT = nullptr;
+        while (len > 1) {
+            if (depth-- == 0) {
+                h = mergeSortList(h);
+                break;
             }
-            else if (cur->d.location == pivot) {
-                if (!eH) eH=eT=cur;
-                else      eT->next=cur, eT=cur;
+            Node* mid = h;
+            Node* end = h;
+            for (size_t i = 1; i < len; ++i) {
+                end = end->next;
+                if (i == len / 2) mid = end;
             }
-            else {
-                if (!gH) gH=gT=cur;
-                else      gT->next=cur, gT=cur;
+            string pivot = psort::median3(h->d.location, mid->d.location, end->d.location,
+                                          [](const string& x, const string& y){ return x.compare(y); });
+            Node *lH=nullptr,*lT=nullptr, *eH=nullptr,*eT=nullptr, *gH=nullptr,*gT=nullptr;
+            size_t ln = 0, gn = 0;
+            for (Node* cur=h; cur; ) {
+                Node* nx = cur->next; cur->next = nullptr;
+                int c = cur->d.location.compare(pivot);
+                if (c < 0) {
+                    if (!lH) lH=lT=cur;
+                    else      lT->next=cur, lT=cur;
+                    ++ln;
+                }
+                else if (c == 0) {
+                    if (!eH) eH=eT=cur;
+                    else      eT->next=cur, eT=cur;
+                }
+                else {
+                    if (!gH) gH=gT=cur;
+                    else      gT->next=cur, gT=cur;
+                    ++gn;
+                }
+                cur = nx;
             }
-            cur = nx;
-        }
-        lH = quickSortList(lH);
-        gH = quickSortList(gH);
-        Node* nh=nullptr; Node* nt=nullptr;
-        auto app=[&](Node* x){
-            if (!x) return;
-            if (!nh) nh=x;
-            else      nt->next=x;
-            nt = x; while (nt->next) nt = nt->next;
-        };
-        app(lH); app(eH); app(gH);
-        return nh;
+            if (ln < gn) {
+                // sorted less-than block, then the equal block, go in front
+                Node* sT = nullptr;
+                lH = quickSortList(lH, ln, depth, &sT);
+                if (lH) { sT->next = eH; eH = lH; }
+                if (!preH) preH = eH;
+                else       preT->next = eH;
+                preT = eT;
+                h = gH; len = gn;
+            } else {
+                // equal block, then the sorted greater-than block, go behind
+                Node* sT = nullptr;
+                gH = quickSortList(gH, gn, depth, &sT);
+                eT->next = gH ? gH : post;
+                if (gH) sT->next = post;
+                if (!post) postT = gH ? sT : eT;
+                post = eH;
+                h = lH; len = ln;
+            }
+        }
+        // h is sorted (or empty); stitch pre + h + post
+        Node* hT = h;
+        while (hT && hT->next) hT = hT->next;
+        if (hT) hT->next = post;
+        Node* body = h ? h : post;
+        if (preT) preT->next = body;
+        if (last) *last = post ? postT : hT ? hT : preT;
+        return preH ? preH : body;
+    }
+    Node* quickSortList(Node* h) {
+        size_t len = 0;
+        for (Node* c = h; c; c = c->next) ++len;
+        return quickSortList(h, len, psort::depthLimit(len), &tail);
     }
 
     // mergesort
@@ -653,6 +1376,45 @@ class LinkedListStore {
         return mergeLists(h, second);
     }
 
+    // Rebuilds the list in the given node order.
+    void relink(const vector<Node*>& order) {
+        head = tail = nullptr;
+        for (Node* x : order) {
+            x->next = nullptr;
+            if (!head) head = tail = x;
+            else       tail->next = x, tail = x;
+        }
+    }
+
+    // Repeat sort of f: no comparisons, at most a relink from the cached
+    // order and a reversal.
+    bool useCachedOrder(Field f, bool asc, const char* what) {
+        SortedOrder& s = sortedBy[int(f)];
+        if (s.loadGen != loadGen) return false;
+        if (listField != int(f)) {
+            relink(s.nodes);
+            listField = int(f);
+            listAsc   = true;
+        }
+        if (listAsc != asc) { reverseList(); listAsc = asc; }
+        ++gen;
+        ++cachedSorts;
+        cout << "[LL] " << what << " " << fieldName(f) << " (" << (asc ? "A-Z" : "Z-A")
+             << ") - cached order from " << s.algo << "\n";
+        return true;
+    }
+    // Records the freshly sorted (ascending) list as f's order.
+    void adoptOrder(Field f, const char* algo) {
+        SortedOrder& s = sortedBy[int(f)];
+        s.nodes.clear();
+        s.nodes.reserve(rows.size());
+        for (Node* c = head; c; c = c->next) s.nodes.push_back(c);
+        s.loadGen = loadGen;
+        s.algo    = algo;
+        listField = int(f);
+        listAsc   = true;
+    }
+
     void reverseList() {
         Node* prev=nullptr;
         Node* cur = head;
@@ -688,6 +1450,15 @@ public:
         n = 0;
         for (int i = 0; i < 4; ++i) channels[i].clear();
         lastChannel.clear();
+        rows.clear();
+        ++gen;
+        ++loadGen;
+        listField = -1;
+        for (auto& s : sortedBy) s = SortedOrder();
+        bix.clear();
+        filters.clear();
+        numIdx.clear();
+        acctIdx.clear();
 
         ifstream f(fn);
         if (!f.is_open()) {
@@ -731,14 +1502,21 @@ public:
             Node* nd = new Node(T);
             if (!head) head = tail = nd;
             else       tail->next = nd, tail = nd;
+            nd->row = uint32_t(rows.size());
+            bix.add(nd->row, T);
+            rows.push_back(nd);
             ++n;
         }
 
+        filters.build(rows.size(), [this](uint32_t r) -> const Transaction& { return rows[r]->d; });
+        locTrie.build(bix.column(Field::location).values);
         cout << "[LL] Loaded " << n << " rows (full) | Distribution: ";
         for (int i = 0; i < 4; ++i) {
             cout << NAMES[i] << ":" << channels[i].count << " ";
         }
         cout << "\n";
+        buildIdIndex();
+        reportFilters();
     }
 
     void exportToJSON(const std::string& fn, const std::string& title) const {
@@ -784,6 +1562,15 @@ public:
             channels[i].clear();
         }
         lastChannel=channel;
+        rows.clear();
+        ++gen;
+        ++loadGen;
+        listField = -1;
+        for (auto& s : sortedBy) s = SortedOrder();
+        bix.clear();
+        filters.clear();
+        numIdx.clear();
+        acctIdx.clear();
 
         ifstream f(fn);
         if (!f.is_open()) { cerr<<"Cannot open "<<fn<<"\n"; return  ; }
@@ -823,15 +1610,22 @@ public:
                 Node* nd = new Node(T);
                 if (!head) head = tail = nd;
                 else       tail->next = nd, tail = nd;
+                nd->row = uint32_t(rows.size());
+                bix.add(nd->row, T);
+                rows.push_back(nd);
             }
             ++n;
         }
 
+        filters.build(rows.size(), [this](uint32_t r) -> const Transaction& { return rows[r]->d; });
+        locTrie.build(bix.column(Field::location).values);
         cout<<"[LL] Loaded "<<n<<" rows | Payment-Channel: " << channel << " | Distribution: ";
         for (int i = 0; i < 4; ++i) {
             cout<< NAMES[i] << ":" << channels[i].count << " ";
         }
         cout<<"\n";
+        buildIdIndex();
+        reportFilters();
     }
 
     int size() const { return n; }
@@ -857,53 +1651,341 @@ public:
         return out;
     }
 
-    // binary searches
-    TransactionList searchByTransactionTypeBinary(const string& key) const {
-        TransactionList flat; flat.clear();
-        for (Node* c = head; c; c = c->next) flat.push(c->d);
-        stable_sort(flat.data, flat.data + flat.count,
-                    [](auto &a, auto &b){ return a.transaction_type < b.transaction_type; });
-        int lo=0, hi=flat.count;
+    // vectorized linear searches over the dictionary-code columns (load order);
+    // ids, if given, receives the matching row ids in result order
+    TransactionList scanVectorized(Field f, const string& key, ScanStats& st,
+                                   vector<uint32_t>* ids = nullptr) const {
+        vector<uint64_t> sel = bix.scanCodes(f, {key}, &st);
+        TransactionList out; out.clear();
+        for (size_t w = 0; w < sel.size(); ++w)
+            for (uint64_t bits = sel[w]; bits; bits &= bits - 1) {
+                uint32_t r = uint32_t(w * 64 + simd::countTrailingZeros64(bits));
+                out.push(rows[r]->d);
+                if (ids) ids->push_back(r);
+            }
+        return out;
+    }
+    TransactionList getByTransactionTypeVectorized(const string& tp, ScanStats& st,
+                                                   vector<uint32_t>* ids = nullptr) const {
+        return scanVectorized(Field::transaction_type, tp, st, ids);
+    }
+    TransactionList getByLocationVectorized(const string& loc, ScanStats& st,
+                                            vector<uint32_t>* ids = nullptr) const {
+        return scanVectorized(Field::location, loc, st, ids);
+    }
+
+    // parallel linear searches over the row-id table (load order; a list
+    // cannot be split without walking it first)
+    template <class Match>
+    TransactionList parallelScan(Match match, ThreadPool& pool, vector<uint32_t>* ids = nullptr) const {
+        size_t chunks = size_t(pool.size()) * 4;
+        vector<vector<uint32_t>> hits(chunks);
+        pool.parallelFor(rows.size(), chunks, [&](size_t c, size_t b, size_t e) {
+            for (size_t r = b; r < e; ++r)
+                if (match(rows[r]->d)) hits[c].push_back(uint32_t(r));
+        });
+
+        vector<size_t> offset(chunks + 1, 0);
+        for (size_t c = 0; c < chunks; ++c) offset[c+1] = offset[c] + hits[c].size();
+        TransactionList out(max<int>(1, int(offset[chunks])));
+        out.count = int(offset[chunks]);
+        if (ids) ids->resize(offset[chunks]);
+        pool.parallelFor(chunks, chunks, [&](size_t c, size_t, size_t) {
+            for (size_t i = 0; i < hits[c].size(); ++i) out.data[offset[c] + i] = rows[hits[c][i]]->d;
+            if (ids) copy(hits[c].begin(), hits[c].end(), ids->begin() + offset[c]);
+        });
+        return out;
+    }
+    TransactionList getByTransactionTypeParallel(const string& tp, ThreadPool& pool,
+                                                 vector<uint32_t>* ids = nullptr) const {
+        return parallelScan([&](const Transaction& t){ return t.transaction_type == tp; }, pool, ids);
+    }
+    TransactionList getByLocationParallel(const string& loc, ThreadPool& pool,
+                                          vector<uint32_t>* ids = nullptr) const {
+        return parallelScan([&](const Transaction& t){ return t.location == loc; }, pool, ids);
+    }
+
+    // binary searches over a stably sorted copy of the node pointers;
+    // ids, if given, receives the matching row ids in result order
+    TransactionList searchByTransactionTypeBinary(const string& key, vector<uint32_t>* ids = nullptr) const {
+        vector<const Node*> flat;
+        flat.reserve(rows.size());
+        for (Node* c = head; c; c = c->next) flat.push_back(c);
+        stable_sort(flat.begin(), flat.end(),
+                    [](const Node* a, const Node* b){ return a->d.transaction_type < b->d.transaction_type; });
+        int lo=0, hi=int(flat.size());
         while (lo<hi) {
             int mid=(lo+hi)/2;
-            if (flat.data[mid].transaction_type < key) lo=mid+1;
+            if (flat[mid]->d.transaction_type < key) lo=mid+1;
             else hi=mid;
         }
         TransactionList out; out.clear();
-        while (lo<flat.count && flat.data[lo].transaction_type==key)
-            out.push(flat.data[lo++]);
+        for (; lo<int(flat.size()) && flat[lo]->d.transaction_type==key; ++lo) {
+            out.push(flat[lo]->d);
+            if (ids) ids->push_back(flat[lo]->row);
+        }
         return out;
     }
 
-    TransactionList searchByLocationBinary(const string& key) const {
-        TransactionList flat; flat.clear();
-        for (Node* c = head; c; c = c->next) flat.push(c->d);
-        stable_sort(flat.data, flat.data + flat.count,
-                    [](auto &a, auto &b){ return a.location < b.location; });
-        int lo=0, hi=flat.count;
+    TransactionList searchByLocationBinary(const string& key, vector<uint32_t>* ids = nullptr) const {
+        vector<const Node*> flat;
+        flat.reserve(rows.size());
+        for (Node* c = head; c; c = c->next) flat.push_back(c);
+        stable_sort(flat.begin(), flat.end(),
+                    [](const Node* a, const Node* b){ return a->d.location < b->d.location; });
+        int lo=0, hi=int(flat.size());
         while (lo<hi) {
             int mid=(lo+hi)/2;
-            if (flat.data[mid].location < key) lo=mid+1;
+            if (flat[mid]->d.location < key) lo=mid+1;
             else hi=mid;
         }
         TransactionList out; out.clear();
-        while (lo<flat.count && flat.data[lo].location==key)
-            out.push(flat.data[lo++]);
+        for (; lo<int(flat.size()) && flat[lo]->d.location==key; ++lo) {
+            out.push(flat[lo]->d);
+            if (ids) ids->push_back(flat[lo]->row);
+        }
+        return out;
+    }
+
+    // bitmap-index searches (row ids = load order, see rows[])
+    Bitmap searchBitmap(const vector<BitmapPredicate>& preds) const {
+        return bix.evaluate(preds);
+    }
+    const BitmapIndex& bitmapIndex() const { return bix; }
+
+    // sorted numeric index for f, built on first use; returns build ms (0 if cached)
+    double ensureNumericIndex(Field f) const {
+        if (numIdx[f].built()) return 0;
+        auto t0 = chrono::high_resolution_clock::now();
+        numIdx[f].build(f, uint32_t(rows.size()),
+            [this](uint32_t r) -> const Transaction& { return rows[r]->d; });
+        auto t1 = chrono::high_resolution_clock::now();
+        return chrono::duration<double, milli>(t1 - t0).count();
+    }
+
+    // range search on a numeric column, inclusive bounds, ascending by value
+    TransactionList searchByRange(Field f, bool hasLo, double lo, bool hasHi, double hi) const {
+        ensureNumericIndex(f);
+        const SortedNumericIndex& ix = numIdx[f];
+        auto pr = ix.range(hasLo, lo, true, hasHi, hi, true);
+        TransactionList out(max<int>(1, int(pr.second - pr.first)));
+        for (size_t i = pr.first; i < pr.second; ++i) out.push(rows[ix.rowAt(i)]->d);
         return out;
     }
 
+    // query engine: plans q in place, fills plan with its EXPLAIN text
+    Bitmap runQuery(QueryNode& q, string& plan) const {
+        vector<Field> numeric;
+        collectNumericFields(q, numeric);
+        for (Field f : numeric) ensureNumericIndex(f);
+
+        QueryIndexes ix;
+        ix.bitmaps = &bix;
+        ix.numeric = &numIdx;
+        ix.ids     = &idIndex;
+        auto eng = makeQueryEngine(ix, uint32_t(rows.size()),
+            [this](uint32_t r) -> const Transaction& { return rows[r]->d; });
+        plan = eng.prepare(q);
+        return eng.execute(q);
+    }
+
+    // trie expansion of a location query, resolved through the bitmap index
+    vector<string> expandLocation(const string& q, DictionaryTrie::Mode m, int maxEdits) const {
+        return locTrie.expand(q, m, maxEdits);
+    }
+    Bitmap locationRows(const vector<string>& values) const {
+        return bix.lookup(Field::location, values);
+    }
+
+    // point lookup through the transaction_id hash index
+    TransactionList searchById(const string& id) const {
+        TransactionList out(1);
+        idIndex.findAll(id, [this](uint32_t r) -> const string& { return rows[r]->d.transaction_id; },
+                        [&](uint32_t r){ out.push(rows[r]->d); });
+        return out;
+    }
+
+    // account history through the CSR index; returns build ms (0 if cached)
+    double ensureAccountIndex() const {
+        if (acctIdx.built()) return 0;
+        auto t0 = chrono::high_resolution_clock::now();
+        acctIdx.build(uint32_t(rows.size()),
+            [this](uint32_t r) -> const Transaction& { return rows[r]->d; });
+        auto t1 = chrono::high_resolution_clock::now();
+        return chrono::duration<double, milli>(t1 - t0).count();
+    }
+    vector<uint32_t> accountRows(const string& acct, AccountIndex::Direction d) const {
+        ensureAccountIndex();
+        return acctIdx.lookup(acct, d, [this](uint32_t r) -> const Transaction& { return rows[r]->d; });
+    }
+    size_t accountIndexBytes() const { return acctIdx.memoryBytes(); }
+
+    uint64_t generation() const { return gen; }
+    uint64_t cacheServedSorts() const { return cachedSorts; }
+
+    // false = key certainly absent from f, no scan needed
+    bool mayContain(Field f, const string& key) const { return filters.mayContain(f, key); }
+
+    // aggregates straight over postings / rows, without a TransactionList
+    const Bitmap* postings(Field f, const string& key) const { return bix.column(f).find(key); }
+    Aggregate aggregate(const Bitmap& ids, bool countOnly) const {
+        return aggregateRows(ids, [this](uint32_t r) -> const Transaction& { return rows[r]->d; }, countOnly);
+    }
+    Aggregate aggregateTable(bool countOnly) const {
+        return aggregateAll(uint32_t(rows.size()), [this](uint32_t r) -> const Transaction& { return rows[r]->d; }, countOnly);
+    }
+
+    // batch search: one group of row ids per key (keys must be distinct).
+    // Scan = one pass over the rows probing a hash index built over the
+    // keys; otherwise one index probe per key. Groups are in row order
+    // either way.
+    vector<vector<uint32_t>> batchSearch(Field f, const vector<string>& keys, bool scan) const {
+        vector<vector<uint32_t>> groups(keys.size());
+        auto keyAt = [&](uint32_t i) -> const string& { return keys[i]; };
+        if (scan) {
+            HashIndex batch;
+            batch.build(uint32_t(keys.size()), keyAt);
+            for (uint32_t r = 0; r < uint32_t(rows.size()); ++r) {
+                int64_t g = batch.find(*stringField(rows[r]->d, f), keyAt);
+                if (g >= 0) groups[g].push_back(r);
+            }
+            return groups;
+        }
+        for (size_t g = 0; g < keys.size(); ++g) {
+            if (!filters.mayContain(f, keys[g])) continue;
+            if (f == Field::transaction_id)
+                idIndex.findAll(keys[g], [this](uint32_t r) -> const string& { return rows[r]->d.transaction_id; },
+                                [&](uint32_t r){ groups[g].push_back(r); });
+            else if (f == Field::sender_account || f == Field::receiver_account)
+                groups[g] = accountRows(keys[g], f == Field::sender_account ? AccountIndex::OUTGOING
+                                                                            : AccountIndex::INCOMING);
+            else if (const Bitmap* p = bix.column(f).find(keys[g])) {
+                p->forEach([&](uint32_t r){ groups[g].push_back(r); });
+                continue;   // bitmaps already iterate in row order
+            }
+            sort(groups[g].begin(), groups[g].end());   // hash / timestamp order -> row order
+        }
+        return groups;
+    }
+
+    // result cursors; cursorWhere walks the list lazily, one match per pull
+    ResultCursor cursorWhere(Field f, const string& key) const {
+        Node* c = head;
+        return ResultCursor([f, key, c]() mutable -> int64_t {
+            while (c) {
+                Node* x = c;
+                c = c->next;
+                if (*stringField(x->d, f) == key) return x->row;
+            }
+            return -1;
+        }, [this](uint32_t r) -> const Transaction& { return rows[r]->d; }, READAHEAD_ROWS);
+    }
+    ResultCursor cursorOver(vector<uint32_t> ids) const {
+        return ResultCursor::overIds(std::move(ids),
+            [this](uint32_t r) -> const Transaction& { return rows[r]->d; });
+    }
+    ResultCursor cursorOver(const Bitmap& ids) const {
+        vector<uint32_t> v;
+        v.reserve(size_t(ids.cardinality()));
+        ids.forEach([&](uint32_t r){ v.push_back(r); });
+        return cursorOver(std::move(v));
+    }
+
     void sortByLocation(bool asc=true) {
+        if (useCachedOrder(Field::location, asc, "Quick-Sorted")) return;
+        ++gen;
+        relink(rows);   // from load order, so ties cache in load order
         head = quickSortList(head);
-        if (!asc) reverseList();
+        adoptOrder(Field::location, "QuickSort");
+        if (!asc) { reverseList(); listAsc = false; }
         cout<<"[LL] Quick-Sorted Location ("<<(asc?"A-Z":"Z-A")<<")\n";
     }
 
+    // MSD radix sort of the row ids, then one relink pass
+    void sortByLocationRadix(bool asc=true) {
+        if (useCachedOrder(Field::location, asc, "Radix-Sorted")) return;
+        ++gen;
+        vector<uint32_t> ord(rows.size());
+        iota(ord.begin(), ord.end(), 0u);
+        strsort::msdRadixSort(ord.data(), ord.size(),
+            [this](uint32_t r) -> const string& { return rows[r]->d.location; });
+        vector<Node*> nodes;
+        nodes.reserve(ord.size());
+        for (uint32_t r : ord) nodes.push_back(rows[r]);
+        relink(nodes);
+        adoptOrder(Field::location, "RadixSort");
+        if (!asc) { reverseList(); listAsc = false; }
+        cout<<"[LL] Radix-Sorted Location ("<<(asc?"A-Z":"Z-A")<<")\n";
+    }
+
+    // stable sort by up to MAX_SORT_KEYS columns over the row ids, then one
+    // relink pass; ties stay in load order under asc and desc keys. A single
+    // column shares that column's cached order, so a single desc key returns
+    // the stable ascending order reversed (ties in reverse load order)
+    void sortByKeys(const vector<SortKey>& keys) {
+        if (keys.size() == 1 && useCachedOrder(keys[0].field, !keys[0].desc, "Key-Sorted")) return;
+        ++gen;
+        vector<SortKey> spec = keys;
+        if (spec.size() == 1) spec[0].desc = false;   // cache ascending, reverse below
+        vector<uint32_t> ord(rows.size());
+        iota(ord.begin(), ord.end(), 0u);
+        vector<const Transaction*> rowp(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) rowp[i] = &rows[i]->d;
+        bool adaptive = sortRowsByKeys(ord.data(), ord.size(), rowp.data(), spec, sharedPool());
+        vector<Node*> nodes;
+        nodes.reserve(ord.size());
+        for (uint32_t r : ord) nodes.push_back(rows[r]);
+        relink(nodes);
+        if (spec.size() == 1) {
+            adoptOrder(spec[0].field, "KeySort");
+            if (keys[0].desc) { reverseList(); listAsc = false; }
+        } else {
+            listField = -1;
+            listAsc   = true;
+        }
+        cout<<"[LL] Key-Sorted ("<<sortKeysLabel(keys)<<")"
+            <<(adaptive ? " - adaptive merge, input mostly in order" : "")<<"\n";
+    }
+
+    // counting sort of the row ids by dictionary rank, then one relink pass
+    void sortByCounting(Field f, bool asc=true) {
+        if (useCachedOrder(f, asc, "Counting-Sorted")) return;
+        ++gen;
+        vector<uint32_t> ord(rows.size());
+        strsort::countingSortByCode(ord.data(), bix.column(f), ord.size());
+        vector<Node*> nodes;
+        nodes.reserve(ord.size());
+        for (uint32_t r : ord) nodes.push_back(rows[r]);
+        relink(nodes);
+        adoptOrder(f, "CountingSort");
+        if (!asc) { reverseList(); listAsc = false; }
+        cout<<"[LL] Counting-Sorted "<<fieldName(f)<<" ("<<(asc?"A-Z":"Z-A")<<")\n";
+    }
+
     void sortByLocationMerge(bool asc=true) {
+        if (useCachedOrder(Field::location, asc, "Merge-Sorted")) return;
+        ++gen;
+        relink(rows);
         head = mergeSortList(head);
-        if (!asc) reverseList();
+        adoptOrder(Field::location, "MergeSort");
+        if (!asc) { reverseList(); listAsc = false; }
         cout<<"[LL] Merge-Sorted Location ("<<(asc?"A-Z":"Z-A")<<")\n";
     }
 
+    // adaptive merge sort of the nodes in load order, then one relink pass
+    void sortByLocationAdaptive(bool asc=true) {
+        if (useCachedOrder(Field::location, asc, "Adaptive-Sorted")) return;
+        ++gen;
+        vector<Node*> nodes(rows.begin(), rows.end());
+        adsort::Stats st = adsort::adaptiveSort(nodes.data(), nodes.size(),
+            [](const Node* x, const Node* y){ return x->d.location < y->d.location; });
+        relink(nodes);
+        adoptOrder(Field::location, "AdaptiveSort");
+        if (!asc) { reverseList(); listAsc = false; }
+        cout<<"[LL] Adaptive-Sorted Location ("<<(asc?"A-Z":"Z-A")<<"): "
+            <<st.runs<<" runs, "<<st.galloped<<" rows galloped\n";
+    }
+
     void printFirstN(int k) const {
         int total=0;
         for (Node* c=head; c && total<k; c=c->next) ++total;
@@ -972,6 +2054,17 @@ public:
         tail = nullptr;
         n    = 0;
         lastChannel.clear();
+        rows.clear();
+        ++gen;
+        ++loadGen;
+        listField = -1;
+        for (auto& s : sortedBy) s = SortedOrder();
+        bix.clear();
+        filters.clear();
+        numIdx.clear();
+        acctIdx.clear();
+        locTrie.clear();
+        idIndex.clear();
 
         // 2) reset the per-channel caches
         for (int i = 0; i < 4; ++i) {
@@ -988,24 +2081,112 @@ const char* LinkedListStore::NAMES[4] = {
 // ------------------------------------------------------------------
 // pagination + search dispatch
 // ------------------------------------------------------------------
+// Prints the Time/RSS lines shared by every timed operation.
+static void reportUsage(const string& prefix, const string& what,
+                        chrono::high_resolution_clock::time_point start,
+                        chrono::high_resolution_clock::time_point stop,
+                        size_t beforeRSS, size_t afterRSS) {
+    auto   dur      = chrono::duration_cast<chrono::microseconds>(stop - start);
+    size_t deltaRSS = (afterRSS >= beforeRSS) ? (afterRSS - beforeRSS) : 0;
+    double beforeMB = double(beforeRSS) / (1024.0 * 1024.0);
+    double afterMB  = double(afterRSS)  / (1024.0 * 1024.0);
+    double deltaMB  = double(deltaRSS)  / (1024.0 * 1024.0);
+    cout << prefix << " " << what << " - Time Used: " << dur.count() / 1000.0 << " ms\n"
+         << prefix << " " << what << " - RSS Before: " << beforeMB << " MB (" << beforeRSS << " bytes)\n"
+         << prefix << " " << what << " - RSS After: "  << afterMB  << " MB (" << afterRSS  << " bytes)\n"
+         << prefix << " " << what << " - Memory Used: " << deltaMB << " MB (" << deltaRSS  << " bytes)\n";
+}
+
+// Reads one bitmap term: blank = skip, "a|b" = OR, leading '!' = NOT.
+// Appends the predicate and its label part; returns false if skipped.
+static bool readBitmapTerm(const string& prompt, Field f,
+                           vector<BitmapPredicate>& preds, string& label) {
+    cout << "  " << prompt << ": ";
+    string in; getline(cin, in);
+    if (in.empty()) return false;
+
+    BitmapPredicate p;
+    p.field = f;
+    if (in[0] == '!') { p.negate = true; in.erase(0, 1); }
+    stringstream ss(in);
+    string v;
+    while (getline(ss, v, '|')) {
+        if (v.empty()) continue;
+        if (f == Field::is_fraud) {
+            transform(v.begin(), v.end(), v.begin(), ::tolower);
+            v = (v == "true" || v == "y" || v == "yes" || v == "1") ? "true" : "false";
+        }
+        p.values.push_back(v);
+    }
+    if (p.values.empty()) return false;
+
+    if (!label.empty()) label += " & ";
+    label += (p.negate ? "!" : "") + string(fieldName(f)) + "=" + in;
+    preds.push_back(std::move(p));
+    return true;
+}
+
+enum SearchAlgo { LINEAR = 1, BINARY = 2, VECTORIZED = 3, PARALLEL = 4 };
+
+// Prints the kernel throughput line of a vectorized scan.
+static void reportScan(const string& prefix, const string& what, const ScanStats& st) {
+    cout << prefix << " " << what << " - Scan Kernel: " << st.micros << " us, "
+         << st.rows << " rows, " << st.bytes << " bytes -> " << st.gbPerSec() << " GB/s ("
+         << (simd::hasAVX2() ? "AVX2" : "scalar") << ")\n";
+}
+
+// Times fn() once on a single thread and prints the speedup of the
+// threads-wide run that took parallelMs.
+template <class Fn>
+static void reportSpeedup(const string& prefix, const string& what,
+                          unsigned threads, double parallelMs, Fn fn) {
+    auto t0 = chrono::high_resolution_clock::now();
+    fn();
+    auto t1 = chrono::high_resolution_clock::now();
+    double serialMs = chrono::duration<double, milli>(t1 - t0).count();
+    cout << prefix << " " << what << " - Speedup: " << (parallelMs > 0 ? serialMs / parallelMs : 0)
+         << "x (1 thread: " << serialMs << " ms, " << threads << " threads: " << parallelMs << " ms)\n";
+}
+
+// Prints the cache line after a cached search.
+static void reportCache(const string& prefix, const string& what, bool hit) {
+    cout << prefix << " " << what << " - Cache: " << (hit ? "hit" : "miss")
+         << " (hits " << queryCache.hits << ", misses " << queryCache.misses
+         << ", " << queryCache.entries() << " entries, "
+         << queryCache.memoryBytes() / (1024.0 * 1024.0) << "/"
+         << queryCache.budgetBytes() / (1024.0 * 1024.0) << " MB)\n";
+}
+
 void handleSearch(bool useArr,
                   ArrayStore& arr,
                   LinkedListStore& ll,
-                  bool useBinary) {
+                  SearchAlgo algo,
+                  unsigned threads = 0) {
+    if (!threads) threads = ThreadPool::hardwareThreads();
     const char* types[] = {"deposit","transfer","withdrawal","payment"};
 
     while (true) {
         cout << "\n-- SEARCH MENU --\n"
              << "  1) By Transaction Type\n"
              << "  2) By Location\n"
-             << "  3) Back\n"
+             << "  3) Multi-criteria (bitmap index)\n"
+             << "  4) Query expression\n"
+             << "  5) Numeric range (amount/velocity/geo)\n"
+             << "  6) Location (any case / prefix / fuzzy)\n"
+             << "  7) By Transaction ID\n"
+             << "  8) By Account (outgoing/incoming/all)\n"
+             << "  9) Aggregate (count/sum/avg/min/max/fraud rate)\n"
+             << " 10) Batch (list of locations / accounts / IDs)\n"
+             << " 11) Back\n"
              << "Choose: ";
         int s;
         if (!(cin >> s)) { cin.clear(); cin.ignore(1e9, '\n'); continue; }
         cin.ignore(1e9, '\n');
-        if (s == 3) break;
+        if (s == 11) break;
 
         TransactionList results;
+        ResultCursor    cursor;
+        bool            lazy = false;   // cursor holds the results, not `results`
         string          label, criterion;
 
         if (s == 1) {
@@ -1022,16 +2203,40 @@ void handleSearch(bool useArr,
             criterion = types[tt-1];
             label     = "Type=" + criterion;
 
+            const void* store = useArr ? (const void*)&arr : (const void*)&ll;
+            uint64_t    gen   = useArr ? arr.generation() : ll.generation();
+            queryCache.dropStale(store, gen);
+            ResultCache::Key key{ store, label, int(algo), gen };
+
             auto start = chrono::high_resolution_clock::now();
             size_t beforeRSS = getProcessRSS();
-            if (useBinary) {
+            ScanStats scan;
+            const vector<uint32_t>* cached = queryCache.find(key);
+            double buildMs = 0;
+            vector<uint32_t> ids;   // row ids of an eager search, for the cache
+            if (cached) {
+                cursor = useArr ? arr.cursorOver(*cached) : ll.cursorOver(*cached);
+                lazy   = true;
+            } else if (algo == BINARY && useArr) {
+                buildMs = arr.ensureSortedIndex(Field::transaction_type);
+                cursor  = arr.cursorOver(arr.binaryRows(Field::transaction_type, criterion));
+                lazy    = true;
+            } else if (algo == BINARY) {
+                results = ll.searchByTransactionTypeBinary(criterion, &ids);
+            } else if (algo == VECTORIZED) {
                 results = useArr
-                        ? arr.searchByTransactionTypeBinary(criterion)
-                        : ll.searchByTransactionTypeBinary(criterion);
-            } else {
+                        ? arr.getByTransactionTypeVectorized(criterion, scan, &ids)
+                        : ll.getByTransactionTypeVectorized(criterion, scan, &ids);
+            } else if (algo == PARALLEL) {
                 results = useArr
-                        ? arr.getByTransactionType(criterion)
-                        : ll.getByTransactionType(criterion);
+                        ? arr.getByTransactionTypeParallel(criterion, sharedPool(threads), &ids)
+                        : ll.getByTransactionTypeParallel(criterion, sharedPool(threads), &ids);
+            } else {
+                // linear: scan only as far as the first page (plus readahead) needs
+                cursor = useArr ? arr.cursorWhere(Field::transaction_type, criterion)
+                                : ll.cursorWhere(Field::transaction_type, criterion);
+                cursor.fetch(PAGE_SIZE);
+                lazy   = true;
             }
             auto stop    = chrono::high_resolution_clock::now();
             size_t afterRSS  = getProcessRSS();
@@ -1044,26 +2249,76 @@ void handleSearch(bool useArr,
             double deltaMB = double(deltaRSS) / (1024.0 * 1024.0);
 
             const char* prefix = useArr ? "[Array]" : "[Linked List]";
-            cout << prefix << " Search Transaction - Time Used: " << dur.count() << " ms\n"
+            // a fresh linear search is lazy: its time covers the first page only
+            const char* timed = (!cached && algo == LINEAR) ? "Time Used (first page): " : "Time Used: ";
+            cout << prefix << " Search Transaction - " << timed << dur.count() << " ms\n"
                 << prefix << " Search Transaction - RSS Before: " << beforeMB << " MB (" << beforeRSS  << " bytes)\n"
                 << prefix << " Search Transaction - RSS After: " << afterMB << " MB (" << afterRSS  << " bytes)\n"
                 << prefix << " Search Transaction - Memory Used: " << deltaMB << " MB (" << deltaRSS  << " bytes)\n";
+            reportCache(prefix, "Search Transaction", cached != nullptr);
+            if (algo == BINARY && useArr && !cached) {
+                cout << prefix << " Search Transaction - Sorted Index: ";
+                if (buildMs > 0) cout << "built in " << buildMs << " ms\n";
+                else             cout << "cached\n";
+            }
+            if (!cached && algo == LINEAR)
+                cout << prefix << " Search Transaction - Lazy: first " << cursor.available()
+                     << " matches ready, the rest are found as pages are read\n";
+            if (!cached && lazy)
+                cursor.onComplete([key](const vector<uint32_t>& ids){ queryCache.put(key, ids); });
+            else if (!cached)
+                queryCache.put(key, std::move(ids));
+            if (algo == VECTORIZED && !cached) reportScan(prefix, "Search Transaction", scan);
+            if (algo == PARALLEL && !cached)
+                reportSpeedup(prefix, "Search Transaction", threads,
+                              chrono::duration<double, milli>(stop - start).count(), [&]{
+                    TransactionList serial = useArr ? arr.getByTransactionTypeParallel(criterion, serialPool())
+                                                    : ll.getByTransactionTypeParallel(criterion, serialPool());
+                });
         }
         else if (s == 2) {
             cout << "Enter location: ";
             getline(cin, criterion);
             label = "Location=" + criterion;
 
+            const void* store = useArr ? (const void*)&arr : (const void*)&ll;
+            uint64_t    gen   = useArr ? arr.generation() : ll.generation();
+            queryCache.dropStale(store, gen);
+            ResultCache::Key key{ store, label, int(algo), gen };
+
             auto start = chrono::high_resolution_clock::now();
             size_t beforeRSS = getProcessRSS();
-            if (useBinary) {
+            ScanStats scan;
+            bool rejected = !(useArr ? arr.mayContain(Field::location, criterion)
+                                     : ll.mayContain(Field::location, criterion));
+            const vector<uint32_t>* cached = rejected ? nullptr : queryCache.find(key);
+            double buildMs = 0;
+            vector<uint32_t> ids;   // row ids of an eager search, for the cache
+            if (rejected) {
+                // absent location: empty result without a scan
+            } else if (cached) {
+                cursor = useArr ? arr.cursorOver(*cached) : ll.cursorOver(*cached);
+                lazy   = true;
+            } else if (algo == BINARY && useArr) {
+                buildMs = arr.ensureSortedIndex(Field::location);
+                cursor  = arr.cursorOver(arr.binaryRows(Field::location, criterion));
+                lazy    = true;
+            } else if (algo == BINARY) {
+                results = ll.searchByLocationBinary(criterion, &ids);
+            } else if (algo == VECTORIZED) {
                 results = useArr
-                        ? arr.searchByLocationBinary(criterion)
-                        : ll.searchByLocationBinary(criterion);
-            } else {
+                        ? arr.getByLocationVectorized(criterion, scan, &ids)
+                        : ll.getByLocationVectorized(criterion, scan, &ids);
+            } else if (algo == PARALLEL) {
                 results = useArr
-                        ? arr.getByLocation(criterion)
-                        : ll.getByLocation(criterion);
+                        ? arr.getByLocationParallel(criterion, sharedPool(threads), &ids)
+                        : ll.getByLocationParallel(criterion, sharedPool(threads), &ids);
+            } else {
+                // linear: scan only as far as the first page (plus readahead) needs
+                cursor = useArr ? arr.cursorWhere(Field::location, criterion)
+                                : ll.cursorWhere(Field::location, criterion);
+                cursor.fetch(PAGE_SIZE);
+                lazy   = true;
             }
             auto stop    = chrono::high_resolution_clock::now();
             size_t afterRSS  = getProcessRSS();
@@ -1076,30 +2331,436 @@ void handleSearch(bool useArr,
             double deltaMB = double(deltaRSS) / (1024.0 * 1024.0);
 
             const char* prefix = useArr ? "[Array]" : "[Linked List]";
-            cout << prefix << " Search Location - Time Used: " << dur.count() << " ms\n"
+            // a fresh linear search is lazy: its time covers the first page only
+            const char* timed = (!cached && algo == LINEAR) ? "Time Used (first page): " : "Time Used: ";
+            cout << prefix << " Search Location - " << timed << dur.count() << " ms\n"
                 << prefix << " Search Location - RSS Before: " << beforeMB << " MB (" << beforeRSS  << " bytes)\n"
                 << prefix << " Search Location - RSS After: " << afterMB << " MB (" << afterRSS  << " bytes)\n"
                 << prefix << " Search Location - Memory Used: " << deltaMB << " MB (" << deltaRSS  << " bytes)\n";
+            if (rejected) {
+                cout << prefix << " Search Location - Bloom filter: key absent, scan skipped\n";
+            } else {
+                reportCache(prefix, "Search Location", cached != nullptr);
+                if (algo == BINARY && useArr && !cached) {
+                    cout << prefix << " Search Location - Sorted Index: ";
+                    if (buildMs > 0) cout << "built in " << buildMs << " ms\n";
+                    else             cout << "cached\n";
+                }
+                if (!cached && algo == LINEAR)
+                    cout << prefix << " Search Location - Lazy: first " << cursor.available()
+                         << " matches ready, the rest are found as pages are read\n";
+                if (!cached && lazy)
+                    cursor.onComplete([key](const vector<uint32_t>& ids){ queryCache.put(key, ids); });
+                else if (!cached)
+                    queryCache.put(key, std::move(ids));
+                if (algo == VECTORIZED && !cached) reportScan(prefix, "Search Location", scan);
+                if (algo == PARALLEL && !cached)
+                    reportSpeedup(prefix, "Search Location", threads,
+                                  chrono::duration<double, milli>(stop - start).count(), [&]{
+                        TransactionList serial = useArr ? arr.getByLocationParallel(criterion, serialPool())
+                                                        : ll.getByLocationParallel(criterion, serialPool());
+                    });
+            }
+        }
+        else if (s == 3) {
+            vector<BitmapPredicate> preds;
+            cout << "\nLeave blank to skip. Use a|b for OR, !a for NOT.\n";
+            readBitmapTerm("Transaction type",      Field::transaction_type,  preds, label);
+            readBitmapTerm("Location",              Field::location,          preds, label);
+            readBitmapTerm("Payment channel",       Field::payment_channel,   preds, label);
+            readBitmapTerm("Merchant category",     Field::merchant_category, preds, label);
+            readBitmapTerm("Device",                Field::device_used,       preds, label);
+            readBitmapTerm("Is fraud (true/false)", Field::is_fraud,          preds, label);
+            if (label.empty()) label = "All";
+
+            auto start = chrono::high_resolution_clock::now();
+            size_t beforeRSS = getProcessRSS();
+            Bitmap ids = useArr ? arr.searchBitmap(preds) : ll.searchBitmap(preds);
+            auto evalStop = chrono::high_resolution_clock::now();
+            cursor = useArr ? arr.cursorOver(ids) : ll.cursorOver(ids);
+            lazy   = true;
+            auto stop = chrono::high_resolution_clock::now();
+            size_t afterRSS = getProcessRSS();
+
+            const char* prefix = useArr ? "[Array]" : "[Linked List]";
+            reportUsage(prefix, "Search Bitmap", start, stop, beforeRSS, afterRSS);
+            cout << prefix << " Search Bitmap - Index Evaluation: "
+                 << chrono::duration_cast<chrono::microseconds>(evalStop - start).count()
+                 << " us (" << ids.cardinality() << " rows, "
+                 << ids.memoryBytes() << " bytes compressed)\n";
+        }
+        else if (s == 4) {
+            cout << "\nExamples:\n"
+                 << "  type = transfer AND location IN (Tokyo, London) AND fraud = true\n"
+                 << "  amount BETWEEN 10000 AND 50000 AND (channel = UPI OR merchant PREFIX re)\n"
+                 << "Query: ";
+            getline(cin, criterion);
+            label = criterion;
+
+            unique_ptr<QueryNode> q;
+            try {
+                q = QueryParser::parse(criterion);
+            } catch (const exception& e) {
+                cout << "Query error: " << e.what() << "\n";
+                continue;
+            }
+
+            auto start = chrono::high_resolution_clock::now();
+            size_t beforeRSS = getProcessRSS();
+            string plan;
+            Bitmap ids = useArr ? arr.runQuery(*q, plan) : ll.runQuery(*q, plan);
+            auto evalStop = chrono::high_resolution_clock::now();
+            cursor = useArr ? arr.cursorOver(ids) : ll.cursorOver(ids);
+            lazy   = true;
+            auto stop = chrono::high_resolution_clock::now();
+            size_t afterRSS = getProcessRSS();
+
+            const char* prefix = useArr ? "[Array]" : "[Linked List]";
+            cout << "\n-- Plan --\n" << plan;
+            reportUsage(prefix, "Query", start, stop, beforeRSS, afterRSS);
+            cout << prefix << " Query - Plan + Evaluation: "
+                 << chrono::duration_cast<chrono::microseconds>(evalStop - start).count()
+                 << " us (" << ids.cardinality() << " rows)\n";
+        }
+        else if (s == 5) {
+            const Field numericFields[] = { Field::amount, Field::velocity_score, Field::geo_anomaly_score };
+            cout << "\nSelect column:\n";
+            for (int i = 0; i < 3; ++i)
+                cout << "  " << (i+1) << ") " << fieldName(numericFields[i]) << "\n";
+            cout << "Choose: ";
+            int fc;
+            if (!(cin >> fc) || fc < 1 || fc > 3) {
+                cin.clear(); cin.ignore(1e9,'\n');
+                continue;
+            }
+            cin.ignore(1e9,'\n');
+            Field f = numericFields[fc-1];
+
+            string loText, hiText;
+            cout << "Min (blank = no lower bound): "; getline(cin, loText);
+            cout << "Max (blank = no upper bound): "; getline(cin, hiText);
+            double lo = 0, hi = 0;
+            try {
+                if (!loText.empty()) lo = stod(loText);
+                if (!hiText.empty()) hi = stod(hiText);
+            } catch (const exception&) {
+                cout << "Invalid number.\n";
+                continue;
+            }
+            label = string(fieldName(f)) + " in [" + (loText.empty() ? "-inf" : loText)
+                  + ", " + (hiText.empty() ? "+inf" : hiText) + "]";
+
+            auto start = chrono::high_resolution_clock::now();
+            size_t beforeRSS = getProcessRSS();
+            double buildMs = useArr ? arr.ensureNumericIndex(f) : ll.ensureNumericIndex(f);
+            auto lookupStart = chrono::high_resolution_clock::now();
+            results = useArr
+                    ? arr.searchByRange(f, !loText.empty(), lo, !hiText.empty(), hi)
+                    : ll.searchByRange(f, !loText.empty(), lo, !hiText.empty(), hi);
+            auto stop = chrono::high_resolution_clock::now();
+            size_t afterRSS = getProcessRSS();
+
+            const char* prefix = useArr ? "[Array]" : "[Linked List]";
+            reportUsage(prefix, "Search Range", start, stop, beforeRSS, afterRSS);
+            cout << prefix << " Search Range - Index Build: ";
+            if (buildMs > 0) cout << buildMs << " ms\n";
+            else             cout << "cached\n";
+            cout << prefix << " Search Range - Lookup: "
+                 << chrono::duration_cast<chrono::microseconds>(stop - lookupStart).count()
+                 << " us (" << results.count << " rows)\n";
+        }
+        else if (s == 6) {
+            cout << "\nMatch mode:\n"
+                 << "  1) Case-insensitive\n"
+                 << "  2) Prefix\n"
+                 << "  3) Fuzzy (edit distance)\n"
+                 << "Choose: ";
+            int mm;
+            if (!(cin >> mm) || mm < 1 || mm > 3) {
+                cin.clear(); cin.ignore(1e9,'\n');
+                continue;
+            }
+            cin.ignore(1e9,'\n');
+            int maxEdits = 0;
+            if (mm == 3) {
+                cout << "Max edits (1-3): ";
+                if (!(cin >> maxEdits) || maxEdits < 1 || maxEdits > 3) {
+                    cin.clear(); cin.ignore(1e9,'\n');
+                    continue;
+                }
+                cin.ignore(1e9,'\n');
+            }
+            cout << "Enter location: ";
+            getline(cin, criterion);
+            auto mode = mm == 1 ? DictionaryTrie::NOCASE
+                      : mm == 2 ? DictionaryTrie::PREFIX : DictionaryTrie::FUZZY;
+
+            auto start = chrono::high_resolution_clock::now();
+            size_t beforeRSS = getProcessRSS();
+            vector<string> matched = useArr ? arr.expandLocation(criterion, mode, maxEdits)
+                                            : ll.expandLocation(criterion, mode, maxEdits);
+            auto expandStop = chrono::high_resolution_clock::now();
+            Bitmap ids = useArr ? arr.locationRows(matched) : ll.locationRows(matched);
+            cursor = useArr ? arr.cursorOver(ids) : ll.cursorOver(ids);
+            lazy   = true;
+            auto stop = chrono::high_resolution_clock::now();
+            size_t afterRSS = getProcessRSS();
+
+            label = "Location~" + criterion + " (";
+            for (size_t i = 0; i < matched.size(); ++i) label += (i ? ", " : "") + matched[i];
+            label += ")";
+
+            const char* prefix = useArr ? "[Array]" : "[Linked List]";
+            reportUsage(prefix, "Search Location (trie)", start, stop, beforeRSS, afterRSS);
+            cout << prefix << " Search Location (trie) - Expansion: "
+                 << chrono::duration_cast<chrono::microseconds>(expandStop - start).count()
+                 << " us -> " << matched.size() << " location(s), " << ids.cardinality() << " rows\n";
+        }
+        else if (s == 7) {
+            cout << "Enter transaction_id: ";
+            getline(cin, criterion);
+            label = "ID=" + criterion;
+
+            // RSS is sampled outside the timed region: reading it costs more than the lookup
+            size_t beforeRSS = getProcessRSS();
+            auto start = chrono::high_resolution_clock::now();
+            bool rejected = !(useArr ? arr.mayContain(Field::transaction_id, criterion)
+                                     : ll.mayContain(Field::transaction_id, criterion));
+            if (!rejected)
+                results = useArr ? arr.searchById(criterion) : ll.searchById(criterion);
+            auto stop = chrono::high_resolution_clock::now();
+            size_t afterRSS = getProcessRSS();
+
+            const char* prefix = useArr ? "[Array]" : "[Linked List]";
+            reportUsage(prefix, "Search ID", start, stop, beforeRSS, afterRSS);
+            if (rejected) cout << prefix << " Search ID - Bloom filter: key absent, probe skipped\n";
+            cout << prefix << " Search ID - Lookup: "
+                 << chrono::duration_cast<chrono::nanoseconds>(stop - start).count() / 1000.0
+                 << " us (" << results.count << " rows)\n";
+        }
+        else if (s == 8) {
+            cout << "Enter account: ";
+            getline(cin, criterion);
+            cout << "\nDirection:\n"
+                 << "  1) Outgoing (sender)\n"
+                 << "  2) Incoming (receiver)\n"
+                 << "  3) All\n"
+                 << "Choose: ";
+            int dc;
+            if (!(cin >> dc) || dc < 1 || dc > 3) {
+                cin.clear(); cin.ignore(1e9,'\n');
+                continue;
+            }
+            cin.ignore(1e9,'\n');
+            auto dir = dc == 1 ? AccountIndex::OUTGOING
+                     : dc == 2 ? AccountIndex::INCOMING : AccountIndex::ALL;
+            const char* dirName[] = { "out", "in", "all" };
+            label = "Account=" + criterion + " (" + dirName[dc-1] + ")";
+
+            auto start = chrono::high_resolution_clock::now();
+            size_t beforeRSS = getProcessRSS();
+            auto mayHave = [&](Field f) {
+                return useArr ? arr.mayContain(f, criterion) : ll.mayContain(f, criterion);
+            };
+            bool rejected = !((dir != AccountIndex::INCOMING && mayHave(Field::sender_account))
+                           || (dir != AccountIndex::OUTGOING && mayHave(Field::receiver_account)));
+            double buildMs = 0;
+            vector<uint32_t> ids;
+            auto lookupStart = chrono::high_resolution_clock::now();
+            if (!rejected) {
+                buildMs = useArr ? arr.ensureAccountIndex() : ll.ensureAccountIndex();
+                lookupStart = chrono::high_resolution_clock::now();
+                ids = useArr ? arr.accountRows(criterion, dir) : ll.accountRows(criterion, dir);
+            }
+            auto lookupStop = chrono::high_resolution_clock::now();
+            cursor = useArr ? arr.cursorOver(ids) : ll.cursorOver(ids);
+            lazy   = true;
+            auto stop = chrono::high_resolution_clock::now();
+            size_t afterRSS = getProcessRSS();
+
+            const char* prefix = useArr ? "[Array]" : "[Linked List]";
+            reportUsage(prefix, "Search Account", start, stop, beforeRSS, afterRSS);
+            if (rejected) {
+                cout << prefix << " Search Account - Bloom filter: account absent, index not consulted\n";
+            } else {
+                cout << prefix << " Search Account - Index Build: ";
+                if (buildMs > 0) cout << buildMs << " ms ("
+                                      << (useArr ? arr.accountIndexBytes() : ll.accountIndexBytes())
+                                         / (1024.0 * 1024.0) << " MB)\n";
+                else             cout << "cached\n";
+                cout << prefix << " Search Account - Lookup: "
+                     << chrono::duration_cast<chrono::microseconds>(lookupStop - lookupStart).count()
+                     << " us (" << ids.size() << " rows, by timestamp)\n";
+            }
+        }
+        else if (s == 9) {
+            cout << "\nAggregate over:\n"
+                 << "  1) Transaction type\n"
+                 << "  2) Location\n"
+                 << "  3) Query expression\n"
+                 << "  4) All rows\n"
+                 << "Choose: ";
+            int ac;
+            if (!(cin >> ac) || ac < 1 || ac > 4) {
+                cin.clear(); cin.ignore(1e9,'\n');
+                continue;
+            }
+            cin.ignore(1e9,'\n');
+            cout << "\nMeasure:\n"
+                 << "  1) COUNT\n"
+                 << "  2) COUNT, SUM/AVG/MIN/MAX amount, fraud rate\n"
+                 << "Choose: ";
+            int mc;
+            if (!(cin >> mc) || mc < 1 || mc > 2) {
+                cin.clear(); cin.ignore(1e9,'\n');
+                continue;
+            }
+            cin.ignore(1e9,'\n');
+            bool countOnly = (mc == 1);
+
+            unique_ptr<QueryNode> q;
+            if (ac == 1 || ac == 2) {
+                cout << "Enter value: ";
+                getline(cin, criterion);
+            } else if (ac == 3) {
+                cout << "Query: ";
+                getline(cin, criterion);
+                try {
+                    q = QueryParser::parse(criterion);
+                } catch (const exception& e) {
+                    cout << "Query error: " << e.what() << "\n";
+                    continue;
+                }
+            }
+
+            auto start = chrono::high_resolution_clock::now();
+            size_t beforeRSS = getProcessRSS();
+            Aggregate agg;
+            if (ac == 1 || ac == 2) {
+                Field f = ac == 1 ? Field::transaction_type : Field::location;
+                const Bitmap* p = useArr ? arr.postings(f, criterion) : ll.postings(f, criterion);
+                if (p) agg = useArr ? arr.aggregate(*p, countOnly) : ll.aggregate(*p, countOnly);
+            } else if (ac == 3) {
+                string plan;
+                Bitmap ids = useArr ? arr.runQuery(*q, plan) : ll.runQuery(*q, plan);
+                agg = useArr ? arr.aggregate(ids, countOnly) : ll.aggregate(ids, countOnly);
+            } else {
+                agg = useArr ? arr.aggregateTable(countOnly) : ll.aggregateTable(countOnly);
+            }
+            auto stop = chrono::high_resolution_clock::now();
+            size_t afterRSS = getProcessRSS();
+
+            const char* prefix = useArr ? "[Array]" : "[Linked List]";
+            reportUsage(prefix, "Aggregate", start, stop, beforeRSS, afterRSS);
+            cout << fixed << setprecision(2)
+                 << "  COUNT      : " << agg.count << "\n";
+            if (!countOnly && agg.count) {
+                cout << "  SUM amount : " << agg.sum << "\n"
+                     << "  AVG amount : " << agg.avg() << "\n"
+                     << "  MIN amount : " << agg.min << "\n"
+                     << "  MAX amount : " << agg.max << "\n"
+                     << "  Fraud rate : " << agg.fraudRate() * 100 << "% ("
+                     << agg.fraud << " of " << agg.count << ")\n";
+            }
+            cout.unsetf(ios::fixed);
+            cout << setprecision(6);
+            continue;
+        }
+        else if (s == 10) {
+            const Field batchFields[] = { Field::location, Field::sender_account,
+                                          Field::receiver_account, Field::transaction_id };
+            cout << "\nBatch column:\n";
+            for (int i = 0; i < 4; ++i)
+                cout << "  " << (i+1) << ") " << fieldName(batchFields[i]) << "\n";
+            cout << "Choose: ";
+            int bc;
+            if (!(cin >> bc) || bc < 1 || bc > 4) {
+                cin.clear(); cin.ignore(1e9,'\n');
+                continue;
+            }
+            cin.ignore(1e9,'\n');
+            Field f = batchFields[bc-1];
+            cout << "\nMethod:\n"
+                 << "  1) One scan, hash-set probe per row\n"
+                 << "  2) One index probe per key\n"
+                 << "Choose: ";
+            int bm;
+            if (!(cin >> bm) || bm < 1 || bm > 2) {
+                cin.clear(); cin.ignore(1e9,'\n');
+                continue;
+            }
+            cin.ignore(1e9,'\n');
+            cout << "Keys (comma-separated, or @file with one per line): ";
+            getline(cin, criterion);
+
+            vector<string> raw, keys;
+            if (!criterion.empty() && criterion[0] == '@') {
+                ifstream kf(criterion.substr(1));
+                if (!kf.is_open()) { cout << "Cannot open " << criterion.substr(1) << "\n"; continue; }
+                for (string k; getline(kf, k); ) raw.push_back(k);
+            } else {
+                stringstream ks(criterion);
+                for (string k; getline(ks, k, ','); ) raw.push_back(k);
+            }
+            unordered_set<string> seen;   // drop blanks and repeats, keep first-seen order
+            for (string& k : raw) {
+                size_t b = k.find_first_not_of(" \t\r"), e = k.find_last_not_of(" \t\r");
+                if (b == string::npos) continue;
+                k = k.substr(b, e - b + 1);
+                if (seen.insert(k).second) keys.push_back(k);
+            }
+            if (keys.empty()) { cout << "No keys.\n"; continue; }
+            label = string("Batch ") + fieldName(f) + " (" + to_string(keys.size()) + " keys)";
+
+            auto start = chrono::high_resolution_clock::now();
+            size_t beforeRSS = getProcessRSS();
+            vector<vector<uint32_t>> groups = useArr ? arr.batchSearch(f, keys, bm == 1)
+                                                     : ll.batchSearch(f, keys, bm == 1);
+            auto stop = chrono::high_resolution_clock::now();
+            size_t afterRSS = getProcessRSS();
+
+            vector<uint32_t> ids;
+            size_t found = 0;
+            for (const auto& g : groups) { ids.insert(ids.end(), g.begin(), g.end()); found += !g.empty(); }
+
+            const char* prefix = useArr ? "[Array]" : "[Linked List]";
+            reportUsage(prefix, "Search Batch", start, stop, beforeRSS, afterRSS);
+            cout << prefix << " Search Batch - " << (bm == 1 ? "1 scan" : "index probes") << ": "
+                 << keys.size() << " keys, " << found << " found, " << ids.size() << " rows\n";
+            for (size_t g = 0; g < keys.size() && g < 20; ++g)
+                cout << "  " << left << setw(24) << keys[g] << " " << groups[g].size() << "\n";
+            if (keys.size() > 20) cout << "  ... " << keys.size() - 20 << " more keys\n";
+
+            cursor = useArr ? arr.cursorOver(std::move(ids)) : ll.cursorOver(std::move(ids));
+            lazy   = true;
         }
         else {
             cout << "Invalid choice.\n";
             continue;
         }
 
-        // Capture these results for export later
-        lastResults = std::move(results);
+        // Capture these results for export later; lazy results are only
+        // copied out on export or before their store changes
+        if (lazy) {
+            lastResults      = TransactionList();
+            lastCursor       = std::move(cursor);
+            lastMaterialized = false;
+        } else {
+            lastResults = std::move(results);
+            cursorOverLastResults();
+        }
         lastLabel   = label;
         hasResults  = true;
 
-        // Paginate *lastResults*
-        int total = lastResults.count;
-        int pages = (total + PAGE_SIZE - 1) / PAGE_SIZE;
-        if (!pages) { cout << "(no records)\n"; continue; }
+        // Paginate lastCursor, evaluating a page (plus readahead) at a time
+        if (!lastCursor.fetch(PAGE_SIZE)) { cout << "(no records)\n"; continue; }
 
         int page = 0;
         while (true) {
             int startIdx = page * PAGE_SIZE;
-            int endIdx   = min(startIdx + PAGE_SIZE, total);
+            int endIdx   = int(min<size_t>(startIdx + PAGE_SIZE, lastCursor.fetch(startIdx + PAGE_SIZE)));
+            int pages    = int((lastCursor.available() + PAGE_SIZE - 1) / PAGE_SIZE);
+            const char* more = lastCursor.exhausted() ? "" : "+";
 
             cout << "\n-- " << lastLabel << " --\n";
             cout << left
@@ -1112,7 +2773,7 @@ void handleSearch(bool useArr,
             cout << string(80, '-') << "\n";
 
             for (int i = startIdx; i < endIdx; ++i) {
-                const auto& t = lastResults.data[i];
+                const auto& t = lastCursor[i];
                 cout << setw(10) << t.transaction_id
                      << " | " << setw(13) << t.payment_channel
                      << " | " << setw(13) << t.transaction_type
@@ -1121,8 +2782,8 @@ void handleSearch(bool useArr,
                      << " | " << setw(12) << t.merchant_category << "\n";
             }
 
-            cout << "-- Page " << (page + 1) << " of " << pages << " --\n"
-                 << "Prev [1] | Next [2] | Back [3] | Jump [4]\n"
+            cout << "-- Page " << (page + 1) << " of " << pages << more << " --\n"
+                 << "Prev [1] | Next [2] | Back [3] | Jump [4] | Last [5]\n"
                  << "Choose: ";
             int nav;
             if (!(cin >> nav)) {
@@ -1133,18 +2794,22 @@ void handleSearch(bool useArr,
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
             if (nav == 1 && page > 0) --page;
-            else if (nav == 2 && page < pages - 1) ++page;
+            else if (nav == 2 && lastCursor.fetch(size_t(page + 1) * PAGE_SIZE + 1) > size_t(page + 1) * PAGE_SIZE) ++page;
             else if (nav == 3) break;
             else if (nav == 4) {
-                cout << "Page (1-" << pages << "): ";
+                cout << "Page (1-" << pages << more << "): ";
                 int tgt;
-                if (!(cin >> tgt) || tgt < 1 || tgt > pages) {
-                    cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                if (!(cin >> tgt) || tgt < 1
+                    || lastCursor.fetch(size_t(tgt - 1) * PAGE_SIZE + 1) <= size_t(tgt - 1) * PAGE_SIZE) {
+                    cin.clear();
                     cout << "...Invalid page number.\n";
                 } else {
                     page = tgt - 1;
                 }
                 cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            } else if (nav == 5) {
+                // the only way to know the last page is to finish the evaluation
+                page = int((lastCursor.drain() - 1) / PAGE_SIZE);
             } else {
                 cout << "...Invalid option.\n";
             }
@@ -1152,6 +2817,143 @@ void handleSearch(bool useArr,
     }
 }
 
+// ------------------------------------------------------------------
+// external sort: CSV -> sorted CSV on disk, paged and exported by
+// streaming from the file (nothing is loaded into a store)
+// ------------------------------------------------------------------
+static const size_t EXTERNAL_ROWS_PER_MARK = 256;
+
+// Same JSON layout as TransactionList::exportToJSON, written row by row.
+static void exportSortedCsvToJSON(const extsort::SortedCsv& sc, const string& fn, const string& title) {
+    namespace fs = std::filesystem;
+    fs::path exportDir = fs::current_path() / "export-files";
+    fs::create_directories(exportDir);
+    ofstream out(exportDir / fn);
+
+    auto element = [&](const json& j, bool first) {
+        string s = j.dump(4);
+        size_t p = 0;
+        while ((p = s.find('\n', p)) != string::npos) { s.insert(p + 1, "    "); p += 5; }
+        out << (first ? "" : ",\n") << "    " << s;
+    };
+    out << "[\n";
+    element(json{ { "title", title } }, true);
+    sc.forEach([&](const string& line) {
+        using extsort::csvField;
+        string amount(csvField(line, int(Field::amount)));
+        element(json{
+            { "transaction_id",    string(csvField(line, int(Field::transaction_id))) },
+            { "payment_channel",   string(csvField(line, int(Field::payment_channel))) },
+            { "transaction_type",  string(csvField(line, int(Field::transaction_type))) },
+            { "location",          string(csvField(line, int(Field::location))) },
+            { "amount",            amount.empty() ? 0.0 : stod(amount) },
+            { "merchant_category", string(csvField(line, int(Field::merchant_category))) }
+        }, false);
+    });
+    out << "\n]";
+}
+
+static void browseSortedCsv(const extsort::SortedCsv& sc, const string& label) {
+    size_t total = sc.size();
+    size_t pages = (total + PAGE_SIZE - 1) / PAGE_SIZE;
+    if (!pages) { cout << "(no records)\n"; return; }
+
+    size_t page = 0;
+    while (true) {
+        cout << "\n-- Sorted file " << sc.path() << ": " << total
+             << " Rows (Page " << page+1 << "/" << pages << ") --\n"
+             << left
+             << setw(10) << "ID"
+             << "| " << setw(15) << "Type"
+             << "| " << setw(13) << "Channel"
+             << "| " << setw(12) << "Location"
+             << "| " << setw(10) << "Amount"
+             << "| " << setw(12) << "Merchant\n"
+             << string(65, '-') << "\n";
+        for (const string& line : sc.rows(page * PAGE_SIZE, PAGE_SIZE)) {
+            using extsort::csvField;
+            cout << setw(10) << csvField(line, int(Field::transaction_id))
+                 << "| " << setw(15) << csvField(line, int(Field::transaction_type))
+                 << "| " << setw(13) << csvField(line, int(Field::payment_channel))
+                 << "| " << setw(12) << csvField(line, int(Field::location))
+                 << "| " << setw(10) << csvField(line, int(Field::amount))
+                 << "| " << setw(12) << csvField(line, int(Field::merchant_category)) << "\n";
+        }
+
+        cout << "-- Page " << page+1 << " of " << pages << " --\n"
+             << "Previous [1] | Next [2] | Back [3] | Jump [4] | Export to JSON [5]\n"
+             << "Choose: ";
+        int cmd;
+        if (!(cin >> cmd)) { cin.clear(); cmd = 0; }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+        if (cmd == 1 && page > 0)              --page;
+        else if (cmd == 2 && page + 1 < pages) ++page;
+        else if (cmd == 3)                     return;
+        else if (cmd == 4) {
+            cout << "Page (1-" << pages << "): ";
+            size_t p;
+            if (cin >> p && p >= 1 && p <= pages) page = p - 1;
+            else { cin.clear(); cout << "...Invalid page number.\n"; }
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+        else if (cmd == 5) {
+            cout << "Enter JSON filename: ";
+            string fn; getline(cin, fn);
+            if (!fn.empty()) {
+                exportSortedCsvToJSON(sc, fn, "[External] Sorted - " + label);
+                cout << "Exported " << total << " rows to " << fn << "\n";
+            }
+        }
+        else cout << "...Invalid option.\n";
+    }
+}
+
+// Sorts the CSV on disk within a memory budget, then pages the result.
+static void runExternalSort(const string& csv) {
+    cout << "Sort columns, up to " << MAX_SORT_KEYS << " (e.g. location, amount desc, timestamp): ";
+    string spec, err;
+    getline(cin, spec);
+    vector<SortKey> keys;
+    if (!parseSortKeys(spec, keys, err)) { cout << "Invalid sort: " << err << "\n"; return; }
+
+    cout << "Memory budget in MB (0 = 64): ";
+    size_t mb = 0;
+    if (!(cin >> mb)) { cin.clear(); mb = 0; }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    if (!mb) mb = 64;
+
+    cout << "Output file (blank = sorted.csv): ";
+    string fn; getline(cin, fn);
+    if (fn.empty()) fn = "sorted.csv";
+    std::filesystem::path exportDir = std::filesystem::current_path() / "export-files";
+    std::filesystem::create_directories(exportDir);
+    string outPath = (exportDir / fn).string();
+
+    vector<uint64_t> marks;
+    extsort::ExternalSorter::Stats st;
+    auto start = chrono::high_resolution_clock::now();
+    size_t beforeRSS = getProcessRSS();
+    try {
+        extsort::ExternalSorter sorter(keys, mb << 20);
+        st = sorter.run(csv, outPath, EXTERNAL_ROWS_PER_MARK, marks);
+    } catch (const exception& ex) {
+        cout << "External sort failed: " << ex.what() << "\n";
+        return;
+    }
+    auto stop = chrono::high_resolution_clock::now();
+    size_t afterRSS = getProcessRSS();
+
+    cout << "[External] Sorted " << st.rows << " rows by " << sortKeysLabel(keys) << ": "
+         << st.runs << " runs of <= " << mb << " MB, " << st.passes << " merge pass(es), "
+         << st.bytes / (1024.0 * 1024.0) << " MB written to " << outPath << "\n"
+         << "[External] Runs: " << st.runMs << " ms, merge: " << st.mergeMs << " ms\n";
+    reportUsage("[External]", "ExternalSort", start, stop, beforeRSS, afterRSS);
+
+    browseSortedCsv(extsort::SortedCsv(outPath, std::move(marks), EXTERNAL_ROWS_PER_MARK, st.rows),
+                    sortKeysLabel(keys));
+}
+
 int main() {
     ArrayStore arr, fullArr;
     LinkedListStore ll, fullLL;
@@ -1164,18 +2966,24 @@ int main() {
         cout << "\n==== PICK DS ====\n"
              << "1) Array-based\n"
              << "2) Linked-list\n"
-             << "3) Exit\n"
+             << "3) External sort (file on disk, larger than RAM)\n"
+             << "4) Exit\n"
              << "Choose: ";
         int ds;
-        while (!(cin >> ds) || ds < 1 || ds > 3) {
+        while (!(cin >> ds) || ds < 1 || ds > 4) {
             cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            cout << "...Please enter 1, 2, or 3.\n";
+            cout << "...Please enter 1, 2, 3, or 4.\n";
         }
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        if (ds == 3) break;
+        if (ds == 4) break;
+        if (ds == 3) {
+            runExternalSort("financial_fraud_detection_dataset.csv");
+            continue;
+        }
         bool useArr = (ds == 1);
 
-        // Load full dataset
+        // Load full dataset (pending lazy results still point into it)
+        settleLastResults();
         if (useArr)
             fullArr.loadAllFromCSV("financial_fraud_detection_dataset.csv");
         else
@@ -1188,7 +2996,7 @@ int main() {
             cout << "\n==== FEATURES ====\n"
                  << "1) Split by Payment Channel\n"
                  << "2) Search (type/location)\n"
-                 << "3) Sort by Location\n"
+                 << "3) Sort Data\n"
                  << "4) Display Data (All)\n"
                  << "5) Export Search Results to JSON\n"
                  << "6) Back\n"
@@ -1261,11 +3069,35 @@ int main() {
                     cout << "\nSelect search algorithm:\n"
                          << "  1) Linear\n"
                          << "  2) Binary\n"
+                         << "  3) Linear (vectorized)\n"
+                         << "  4) Linear (parallel)\n"
+                         << "  5) Binary search benchmark (lo/hi vs Eytzinger)\n"
                          << "Choose: ";
-                } while (!(cin >> alg) || alg < 1 || alg > 2);
+                } while (!(cin >> alg) || alg < 1 || alg > 5);
                 cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-                handleSearch(useArr, fullArr, fullLL, alg == 2);
+                if (alg == 5) {
+                    if (!useArr) { cout << "Benchmark runs on the array store only.\n"; break; }
+                    int bf;
+                    do {
+                        cout << "\nBenchmark column:\n"
+                             << "  1) transaction_type\n"
+                             << "  2) location\n"
+                             << "Choose: ";
+                    } while (!(cin >> bf) || bf < 1 || bf > 2);
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    fullArr.benchmarkBinarySearch(bf == 1 ? Field::transaction_type : Field::location);
+                    break;
+                }
+
+                unsigned threads = 0;
+                if (alg == PARALLEL) {
+                    cout << "Threads (0 = all " << ThreadPool::hardwareThreads() << " cores): ";
+                    if (!(cin >> threads)) { cin.clear(); threads = 0; }
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                }
+
+                handleSearch(useArr, fullArr, fullLL, SearchAlgo(alg), threads);
                 break;
             }
             case 3: {  // Sort on full dataset
@@ -1274,27 +3106,80 @@ int main() {
                     cout << "\nChoose sorting algorithm:\n"
                          << "  1) Quick Sort\n"
                          << "  2) Merge Sort\n"
+                         << "  3) MSD Radix Sort\n"
+                         << "  4) Counting Sort (dictionary codes)\n"
+                         << "  5) Quick Sort (task-parallel)\n"
+                         << "  6) Multi-column sort (any fields)\n"
+                         << "  7) Top-K view (orders only the pages shown)\n"
+                         << "  8) Adaptive merge sort (fast on mostly sorted data)\n"
+                         << "  9) Sort benchmark (all algorithms)\n"
                          << "Choose: ";
-                } while (!(cin >> sa) || (sa != 1 && sa != 2));
+                } while (!(cin >> sa) || sa < 1 || sa > 9);
                 cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-                int d;
-                do {
-                    cout << "  1) A-Z\n"
-                         << "  2) Z-A\n"
-                         << "Choose: ";
-                } while (!(cin >> d) || (d != 1 && d != 2));
-                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                bool parallelSort = (sa == 5 || sa == 9);
+                if ((parallelSort || sa == 7) && !useArr) { cout << "This sort runs on the array store only.\n"; break; }
+                unsigned threads = 0;
+                if (parallelSort) {
+                    cout << "Threads (0 = all " << ThreadPool::hardwareThreads() << " cores): ";
+                    if (!(cin >> threads)) { cin.clear(); threads = 0; }
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                }
+                if (sa == 9) { fullArr.benchmarkLocationSort(threads); break; }
+
+                vector<SortKey> sortKeys;
+                if (sa == 6) {
+                    cout << "Sort columns, up to " << MAX_SORT_KEYS
+                         << " (e.g. location, amount desc, timestamp): ";
+                    string spec, err;
+                    getline(cin, spec);
+                    if (!parseSortKeys(spec, sortKeys, err)) { cout << "Invalid sort: " << err << "\n"; break; }
+                }
 
-                bool asc = (d == 1);
+                Field sortField = Field::location;
+                if (sa == 4) {
+                    int sf;
+                    do {
+                        cout << "  1) location\n"
+                             << "  2) transaction_type\n"
+                             << "Choose: ";
+                    } while (!(cin >> sf) || (sf != 1 && sf != 2));
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    if (sf == 2) sortField = Field::transaction_type;
+                }
+
+                bool asc = true;
+                if (sa != 6) {   // multi-column sorts carry a direction per column
+                    int d;
+                    do {
+                        cout << "  1) A-Z\n"
+                             << "  2) Z-A\n"
+                             << "Choose: ";
+                    } while (!(cin >> d) || (d != 1 && d != 2));
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    asc = (d == 1);
+                }
+
+                settleLastResults();   // lazy results scan in the current order
+                uint64_t cachedBefore = useArr ? fullArr.cacheServedSorts() : fullLL.cacheServedSorts();
                 auto start = chrono::high_resolution_clock::now();
                 size_t beforeRSS = getProcessRSS();
                 if (useArr) {
                     if (sa == 1)      fullArr.sortByLocation(asc);
-                    else              fullArr.sortByLocationMerge(asc);
+                    else if (sa == 2) fullArr.sortByLocationMerge(asc);
+                    else if (sa == 3) fullArr.sortByLocationRadix(asc);
+                    else if (sa == 4) fullArr.sortByCounting(sortField, asc);
+                    else if (sa == 5) fullArr.sortByLocationParallel(asc, threads);
+                    else if (sa == 6) fullArr.sortByKeys(sortKeys);
+                    else if (sa == 7) fullArr.sortByLocationTopK(asc);
+                    else              fullArr.sortByLocationAdaptive(asc);
                 } else {
                     if (sa == 1)      fullLL.sortByLocation(asc);
-                    else              fullLL.sortByLocationMerge(asc);
+                    else if (sa == 2) fullLL.sortByLocationMerge(asc);
+                    else if (sa == 3) fullLL.sortByLocationRadix(asc);
+                    else if (sa == 4) fullLL.sortByCounting(sortField, asc);
+                    else if (sa == 6) fullLL.sortByKeys(sortKeys);
+                    else              fullLL.sortByLocationAdaptive(asc);
                 }
                 auto stop    = chrono::high_resolution_clock::now();
                 size_t afterRSS  = getProcessRSS();
@@ -1308,7 +3193,13 @@ int main() {
                 double deltaMB = double(deltaRSS) / (1024.0 * 1024.0);
 
                 const char* prefix = useArr ? "[Array]" : "[Linked List]";
-                const char* algName = (sa == 1) ? "QuickSort" : "MergeSort";
+                static const char* const ALG_NAMES[] = { "QuickSort", "MergeSort", "RadixSort", "CountingSort", "ParallelQuickSort", "KeySort", "TopKView", "AdaptiveSort" };
+                const char* algName = ALG_NAMES[sa - 1];
+                if ((useArr ? fullArr.cacheServedSorts() : fullLL.cacheServedSorts()) != cachedBefore) {
+                    cout << prefix << algName << " - Cache hit: no sort ran, cached order reused in "
+                         << dur.count() << " ms\n";
+                    break;
+                }
                 cout << prefix << algName << " - Time Used: " << dur.count() << " ms\n"
                     << prefix << algName << " - RSS Before: " << beforeMB << " MB (" << beforeRSS  << " bytes)\n"
                     << prefix << algName << " - RSS After: " << afterMB << " MB (" << afterRSS  << " bytes)\n"
@@ -1328,6 +3219,7 @@ int main() {
                         cout << "Enter JSON filename: ";
                         string fn; getline(cin, fn);
                         if (fn.empty()) break;
+                        settleLastResults();
                         string store = useArr ? "[Array]" : "[Linked List]";
                         string title = store + " Search - " + lastLabel;
                         lastResults.exportToJSON(fn, title);